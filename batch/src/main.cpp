@@ -0,0 +1,52 @@
+#include "ofMain.h"
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+//========================================================================
+int main(int argc, char *argv[]){
+    //usage: batch <sketch> [-n count] [-j threads] [-o dir] [-c cachedir] [-f formats] [-sizes sides] [-k seconds] [-resume] [hex seeds...]
+    //       batch <sketch> [-n count] [-f formats] [-sizes sides] [hex seeds...] -push queuedir [-r seeds per job]
+    //       batch <sketch> -s factor [-tile size] [-n count] [-j threads] [-o dir] [-f png|png16] [hex seeds...]
+    //       batch -work queuedir [-j threads] [-t timeout] [-k seconds] [-resume]
+    auto app = std::make_shared<ofApp>();
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-n" && i+1 < argc) app->count = stoi(argv[++i]);
+        else if(arg == "-j" && i+1 < argc) app->threads = stoi(argv[++i]);
+        else if(arg == "-o" && i+1 < argc) app->dir = string(argv[++i]) + "/";
+        else if(arg == "-c" && i+1 < argc) app->cache = string(argv[++i]) + "/";
+        else if(arg == "-push" && i+1 < argc) app->push = argv[++i];
+        else if(arg == "-work" && i+1 < argc) app->work = argv[++i];
+        else if(arg == "-r" && i+1 < argc) app->per_job = max(1, stoi(argv[++i]));
+        else if(arg == "-t" && i+1 < argc) app->timeout = stoi(argv[++i]);
+        else if(arg == "-k" && i+1 < argc) app->checkpoint_every = stod(argv[++i]);
+        else if(arg == "-resume") app->resume = true;
+        else if(arg == "-s" && i+1 < argc) app->factor = max(1, stoi(argv[++i]));
+        else if(arg == "-tile" && i+1 < argc) app->tile = max(16, stoi(argv[++i]));
+        else if(arg == "-f" && i+1 < argc) {
+            try {
+                app->formats = imageFormats(argv[++i]);
+            } catch(std::invalid_argument &e) {
+                cerr << e.what() << endl;
+                return 1;
+            }
+        }
+        else if(arg == "-sizes" && i+1 < argc) {
+            try {
+                app->sizes = imageSizes(argv[++i]);
+            } catch(std::invalid_argument &e) {
+                cerr << e.what() << endl;
+                return 1;
+            }
+        }
+        else if(app->name.empty()) app->name = arg;
+        else app->seeds.push_back(stoul(arg, nullptr, 16));
+    }
+
+    ofWindowSettings settings;
+    auto window = std::make_shared<ofAppNoWindow>();
+    window->setup(settings);
+    ofGetMainLoop()->addWindow(window);
+    ofRunApp(window, app);
+    ofRunMainLoop();
+}
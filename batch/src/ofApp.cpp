@@ -0,0 +1,212 @@
+#include "ofApp.h"
+#include "../../common/sketches.h"
+#include "../../common/pool.h"
+#include "../../common/queue.h"
+#include "../../common/cache.h"
+#include "../../common/writer.h"
+#include "../../common/tiles.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+    if(!work.empty()) {
+        runWorker();
+        ofExit();
+        return;
+    }
+
+    if(!makeSketch(name)) {
+        cerr << "usage: batch <sketch> [-n count] [-j threads] [-o dir] [-c cachedir] [-f formats] [-sizes sides] [-k seconds] [-resume] [hex seeds...]" << endl;
+        cerr << "       batch <sketch> [-n count] [-f formats] [-sizes sides] [hex seeds...] -push queuedir [-r seeds per job]" << endl;
+        cerr << "       batch <sketch> -s factor [-tile size] [-n count] [-j threads] [-o dir] [-f png|png16] [hex seeds...]" << endl;
+        cerr << "       batch -work queuedir [-j threads] [-t timeout] [-k seconds] [-resume]" << endl;
+        cerr << "sketches:";
+        for(auto &s : sketchNames()) cerr << " " << s;
+        cerr << endl;
+        cerr << "formats: jpg png png16, comma separated" << endl;
+        cerr << "sizes: longest sides of smaller copies, comma separated, like 1080,540" << endl;
+        ofExit(1);
+        return;
+    }
+
+    std::random_device rd;
+    if(seeds.empty() && !count) count = 1;
+    for(int i = 1; i <= count; i++)
+        seeds.push_back(rd());
+
+    if(factor > 1 || tile) renderPrints(name, seeds, dir, formats);
+    else if(!push.empty()) pushJobs();
+    else render(name, seeds, dir, cache, formats, sizes);
+    ofExit();
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+
+}
+
+//--------------------------------------------------------------
+bool ofApp::render(const string &sketch, const vector<int> &seeds, const string &out, const string &cache_dir, const vector<image_format> &formats, const vector<int> &sizes){
+    thread_pool pool(threads);
+    image_writer writer(pool.size()); //encodes while the threads go on to the next seed
+    render_cache cache(cache_dir);
+    std::mutex lock; //stdout and ok are shared
+    bool ok = true;
+
+    auto place = [&](const string &key, int seed) { //copy the finished render out of the cache
+        std::stringstream seedstring;
+        seedstring << std::hex << (unsigned int)seed;
+        bool placed = cache.place(key, out + seedstring.str(), formats, sizes);
+        std::lock_guard<std::mutex> guard(lock);
+        if(placed) cout << seedstring.str() << endl;
+        else ok = false;
+        return placed;
+    };
+
+    for(int seed : seeds)
+        pool.submit([&, seed] {
+            auto generator = std::shared_ptr<::sketch>(makeSketch(sketch));
+            generator->formats = formats;
+            generator->sizes = sizes;
+            string key = renderKey(*generator, seed, 0);
+            if(cache.has(key, formats, sizes)) {
+                place(key, seed);
+                return;
+            }
+            generator->start(seed, std::make_unique<cpu_canvas>()); //fbos can't leave the gl thread
+            string manifest = generator->manifest(); //before rendering changes anything
+            string checkpoint = cache.checkpoint(key);
+            if(resume) generator->restore(checkpoint);
+            generator->checkpoint_path = checkpoint;
+            generator->checkpoint_every = checkpoint_every;
+            generator->render();
+            auto pix = std::make_shared<image_pixels>(generator->readback());
+            generator->buffer.reset(); //the canvas is most of the memory, it's not kept waiting for the writer
+            writer.submit([&, generator, pix, key, manifest, checkpoint, seed] {
+                if(cache.store(*generator, *pix, key, manifest)) {
+                    unlink(checkpoint.c_str()); //finished with
+                    return place(key, seed);
+                }
+                std::lock_guard<std::mutex> guard(lock);
+                ok = false;
+                return false;
+            });
+        });
+
+    pool.wait();
+    writer.wait();
+    return ok;
+}
+
+//--------------------------------------------------------------
+bool ofApp::renderPrints(const string &sketch, const vector<int> &seeds, const string &out, const vector<image_format> &formats){
+    bool png = false;
+    for(auto &f : formats) png = png || f.ext == "png";
+    if(!png) {
+        cerr << "prints are written as png or png16, try -f png16" << endl;
+        return false;
+    }
+    thread_pool pool(threads); //every thread on the tiles of one seed at a time
+    bool ok = true;
+    for(int seed : seeds) {
+        auto make = [&] { return makeSketch(sketch); };
+        auto probe = make();
+        std::stringstream base;
+        base << out << std::hex << (unsigned int)seed << std::dec << "-" << probe->width * factor << "x" << probe->height * factor;
+        if(renderTiles(make, seed, factor, tile ? tile : 4096, formats, base.str(), pool)) cout << std::hex << (unsigned int)seed << std::dec << endl;
+        else {
+            cerr << "couldn't write " << base.str() << ".png" << endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+//--------------------------------------------------------------
+void ofApp::pushJobs(){
+    work_queue queue(push, timeout);
+    for(int i = 0; i < seeds.size(); i += per_job) {
+        std::stringstream job, contents;
+        job << name << "-" << std::hex << (unsigned int)seeds[i] << "-" << std::dec << min(per_job, (int)seeds.size()-i);
+        contents << "sketch=" << name << " seeds=" << std::hex;
+        for(int j = i; j < seeds.size() && j < i+per_job; j++)
+            contents << (j > i ? "," : "") << (unsigned int)seeds[j];
+        contents << " formats=" << formatNames(formats);
+        if(!sizes.empty()) contents << " sizes=" << sizeNames(sizes);
+        if(queue.push(job.str(), contents.str())) cout << job.str() << endl;
+        else cerr << "couldn't queue " << job.str() << endl;
+    }
+}
+
+//--------------------------------------------------------------
+void ofApp::runWorker(){
+    work_queue queue(work, timeout);
+
+    while(true) {
+        queue.requeueStale();
+        string job = queue.claim();
+        if(job.empty()) {
+            if(queue.idle()) break;
+            ofSleepMillis(1000); //others are still working, wait in case one of them dies
+            continue;
+        }
+
+        string sketch;
+        vector<int> job_seeds;
+        vector<image_format> job_formats = defaultFormats(); //jobs pushed before formats were written down
+        vector<int> job_sizes;
+        bool readable = true;
+        std::stringstream words(queue.read(job));
+        string word;
+        while(words >> word) {
+            if(word.find("sketch=") == 0) sketch = word.substr(7);
+            else if(word.find("seeds=") == 0) {
+                std::stringstream list(word.substr(6));
+                string seed;
+                try {
+                    while(getline(list, seed, ','))
+                        job_seeds.push_back(stoul(seed, nullptr, 16));
+                } catch(std::exception &) { //a seed that isn't hex, or too long
+                    readable = false;
+                }
+            }
+            else if(word.find("formats=") == 0) {
+                try {
+                    job_formats = imageFormats(word.substr(8));
+                } catch(std::invalid_argument &) {
+                    job_formats.clear();
+                }
+            }
+            else if(word.find("sizes=") == 0) {
+                try {
+                    job_sizes = imageSizes(word.substr(6));
+                } catch(std::invalid_argument &) {
+                    readable = false;
+                }
+            }
+        }
+        if(!readable || !makeSketch(sketch) || job_seeds.empty() || job_formats.empty()) {
+            queue.fail(job, "can't read job");
+            continue;
+        }
+
+        //keep the claim alive while the seeds render
+        std::atomic<bool> rendering(true);
+        std::thread heartbeat([&] {
+            for(int t = 1; rendering; t++) {
+                ofSleepMillis(100);
+                if(t % (timeout*10/4+1) == 0) queue.heartbeat(job);
+            }
+        });
+        bool ok = render(sketch, job_seeds, work + "/images/", work + "/cache/", job_formats, job_sizes);
+        rendering = false;
+        heartbeat.join();
+
+        if(ok) queue.finish(job);
+        else queue.fail(job, "couldn't save every image");
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ofMain.h"
+#include "../../common/encoder.h"
+
+//renders every seed given, or count random ones, on a pool of threads
+//with -push the seeds are written to a shared queue directory as jobs instead,
+//and -work renders jobs from that directory until none are left
+//renders already in the cache are copied out instead of drawn again
+//with -k each render in progress is checkpointed into the cache every so many seconds,
+//and -resume picks those up, so a killed run or a requeued job carries on where it was
+//-s renders prints at a multiple of the sketch's size, tile by tile (see tiles.h), straight to the
+//output directory as <seed>-<width>x<height>.png
+
+class ofApp : public ofBaseApp{
+
+	public:
+        string name;
+        string dir = "../images/";
+        string cache = "../cache/"; //finished renders by key, seeds found here aren't rendered again
+        vector<int> seeds;
+        int count = 0;
+        int threads = 0; //0 is one per core
+        vector<image_format> formats = defaultFormats(); //written for every seed
+        vector<int> sizes = defaultSizes(); //longest sides of the smaller copies, <seed>-<size>.<ext>
+        double checkpoint_every = 0; //seconds, 0 for none
+        bool resume = false;
+        int factor = 1; //print size as a multiple of the sketch's
+        int tile = 0; //print pixels a side, 0 for no tiles unless there's a factor
+
+        string push, work; //queue directories
+        int per_job = 16; //seeds in each pushed job
+        int timeout = 300; //seconds before a silent worker's job is requeued
+
+		void setup();
+		void update();
+		void draw();
+
+        bool render(const string &sketch, const vector<int> &seeds, const string &out, const string &cache_dir, const vector<image_format> &formats, const vector<int> &sizes);
+        bool renderPrints(const string &sketch, const vector<int> &seeds, const string &out, const vector<image_format> &formats);
+        void pushJobs();
+        void runWorker();
+		
+};
@@ -0,0 +1,409 @@
+#include "ofMain.h"
+#include "../../common/sketches.h"
+
+//microbenchmarks for the inner loops of every sketch
+//usage: bench [-f filter] [-t seconds per benchmark] [-json file]
+//everything is seeded with the same constants so runs can be compared between builds
+
+const unsigned int seed = 0x56798ae7;
+
+struct result {
+    string name;
+    long long iterations;
+    double ns_per_op;
+    double items_per_second;
+};
+
+vector<result> results;
+string filter;
+double min_time = 0.5;
+double sink = 0; //results are added here so the compiler can't throw the work away
+
+//time f, which does one op of `items` items, doubling the op count until it runs long enough
+template<typename F>
+void bench(const string &name, double items, F f) {
+    if(!filter.empty() && name.find(filter) == string::npos) return;
+    long long n = 1;
+    double elapsed;
+    while(true) {
+        auto start = std::chrono::steady_clock::now();
+        for(long long i = 0; i < n; i++) f();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(elapsed >= min_time || n >= (1ll << 40)) break;
+        n = (elapsed < min_time / 100 ? n * 10 : n * 2);
+    }
+    result r = {name, n, elapsed * 1e9 / n, n * items / elapsed};
+    results.push_back(r);
+    printf("%-36s %12lld %12.1f ns/op %14.0f items/s\n", r.name.c_str(), r.iterations, r.ns_per_op, r.items_per_second);
+    fflush(stdout);
+}
+
+vector<ofVec3f> randomPoints(rng &r, int n, double range) {
+    vector<ofVec3f> v;
+    for(int i = 0; i < n; i++)
+        v.push_back(ofVec3f(r.random(-range, range), r.random(-range, range), r.random(-range, range)));
+    return v;
+}
+
+void benchRng() {
+    rng r;
+    r.seed(seed);
+    r.exact = false;
+    bench("rng/uniform", 1, [&] { sink += r.uniform(); });
+    bench("rng/gaussian", 1, [&] { sink += r.gaussian(240, 30); });
+    vector<double> column(2000); //a column of paper grain
+    bench("rng/gaussians", column.size(), [&] {
+        r.gaussians(column.data(), column.size(), 240, 30);
+        sink += column[0];
+    });
+    r.exact = true;
+    bench("rng/gaussian/exact", 1, [&] { sink += r.gaussian(240, 30); });
+}
+
+void benchNoise() {
+    rng r;
+    r.seed(seed);
+    const int n = 1024;
+    vector<float> x(n), y(n), z(n), w(n), out(n);
+    vector<double> sums(n);
+    for(int i = 0; i < n; i++) x[i] = r.random(-4, 4), y[i] = r.random(-4, 4), z[i] = r.random(-4, 4), w[i] = r.random(1000);
+    int i = 0;
+    bench("noise/2d", 1, [&] { i = (i + 1) & (n - 1); sink += noise::noise(x[i], y[i]); });
+    bench("noise/3d", 1, [&] { i = (i + 1) & (n - 1); sink += noise::noise(x[i], y[i], z[i]); });
+    bench("noise/4d", 1, [&] { i = (i + 1) & (n - 1); sink += noise::noise(x[i], y[i], z[i], w[i]); });
+    bench("noise/2d/batch", n, [&] { noise::noise(n, x.data(), y.data(), out.data()); sink += out[0]; });
+    bench("noise/3d/batch", n, [&] { noise::noise(n, x.data(), y.data(), z.data(), out.data()); sink += out[0]; });
+    bench("noise/4d/batch", n, [&] { noise::noise(n, x.data(), y.data(), z.data(), w.data(), out.data()); sink += out[0]; });
+    bench("noise/fbm/3d/4 octaves", n, [&] { noise::fbm(n, x.data(), y.data(), 523.5, 4, sums.data()); sink += sums[0]; });
+    bench("noise/fbm/4d/2 octaves", n, [&] { noise::fbm(n, x.data(), y.data(), z.data(), 523.5, 2, sums.data()); sink += sums[0]; });
+}
+
+void benchGrain() {
+    if(!filter.empty() && string("grain/make grain/drawShades grain/drawPoint").find(filter) == string::npos) return;
+    rng r;
+    r.seed(seed);
+    r.exact = false;
+    const int size = 1801; //cell and walker's
+    auto g = grain::make(r, 100, 100, size, size);
+    bench("grain/make", size * size, [&] { sink += grain::make(r, 100, 100, size, size)->levels[0]; });
+    cpu_canvas c;
+    c.allocate(2000, 2000);
+    c.background(ofColor(255));
+    bench("grain/drawShades", size * size, [&] { c.drawShades(g->levels.data(), 100, 100, size, size, 60); });
+    bench("grain/drawPoint", size * size, [&] { //how it used to be drawn
+        for(int y = 0; y < size; y++)
+            for(int x = 0; x < size; x++) {
+                int shade = g->levels[(size_t)y * size + x];
+                c.setColor(ofColor(shade, shade, shade, 60));
+                c.drawPoint(100 + x, 100 + y);
+            }
+    });
+}
+
+void benchEncode() {
+    if(!filter.empty() && string("encode/jpg encode/jpg/1 thread encode/png encode/png/1 thread encode/png16 downscale/1080 downscale/540 downscale/1080/16 bit").find(filter) == string::npos) return;
+    rng r;
+    r.seed(seed);
+    r.exact = false;
+    cpu_canvas c; //paper grain under some colored glow, roughly what the sketches save
+    c.allocate(2000, 2000);
+    c.background(ofColor(255));
+    auto g = grain::make(r, 0, 0, 2000, 2000);
+    c.drawShades(g->levels.data(), 0, 0, 2000, 2000, 60);
+    c.enableBlendMode(OF_BLENDMODE_ADD);
+    for(int i = 0; i < 200; i++) {
+        c.setColor(ofColor(r.random(255), r.random(255), r.random(255), 20));
+        c.drawRectangle(r.random(2000), r.random(2000), r.random(400), r.random(400));
+    }
+    image_pixels pix;
+    c.readToPixels(pix.pixels);
+    c.readToPixels(pix.deep);
+
+    string path = temporaryPath("bench");
+    thread_pool one(1);
+    bench("encode/jpg", 2000 * 2000, [&] { sink += saveJpeg(pix.pixels, path, encoderThreads()); });
+    bench("encode/jpg/1 thread", 2000 * 2000, [&] { sink += saveJpeg(pix.pixels, path, one); });
+    bench("encode/png", 2000 * 2000, [&] { sink += savePng(pix.pixels, path, encoderThreads()); });
+    bench("encode/png/1 thread", 2000 * 2000, [&] { sink += savePng(pix.pixels, path, one); });
+    bench("encode/png16", 2000 * 2000, [&] { sink += savePng(pix.deep, path, encoderThreads()); });
+    bench("downscale/1080", 2000 * 2000, [&] { sink += downscale(pix.pixels, 1080).getData()[0]; });
+    bench("downscale/540", 2000 * 2000, [&] { sink += downscale(pix.pixels, 540).getData()[0]; });
+    bench("downscale/1080/16 bit", 2000 * 2000, [&] { sink += downscale(pix.deep, 1080).getData()[0]; });
+    unlink(path.c_str());
+}
+
+void benchField() {
+    rng r;
+    r.seed(seed);
+    auto points = randomPoints(r, 1024, 1);
+    vector<double> aff;
+    for(int i = 1; i <= 12; i++) aff.push_back(r.random(1.2)*(r.random(1) <= 0.5 ? -1 : 1));
+
+    field::fract fr(r, field::variations(), {0.1, 0.45, 0.8});
+    bench("field/fract::step", 1, [&] { sink += fr.step(r).x; });
+
+    for(auto &name : field::variations()) {
+        int i = 0;
+        bench("field/variation/" + name, 1, [&] { sink += field::resolveVariation(name, points[i++ & 1023], aff).x; });
+    }
+}
+
+void benchFlow() {
+    rng r;
+    r.seed(seed);
+    auto points = randomPoints(r, 1024, 4);
+
+    flow::vector_field f;
+    f.noise_seed = r.random(1000);
+    f.speed = 0.1;
+    f.octaves = 3;
+    for(int i = 1; i <= 3; i++) f.formula.push_back({flow::randVariation(r), (int)r.random(5)});
+    for(int i = 1; i <= 12; i++) f.aff.push_back(r.random(1.2)*(r.random(1) <= 0.5 ? -1 : 1));
+    f.hues = {0.1, 0.45, 0.8};
+
+    vector<flow::particle> particles;
+    for(auto &p : points) particles.push_back(flow::particle(f, p));
+
+    int i = 0, steps = 0;
+    bench("flow/particle::update", 1, [&] {
+        if(++steps == 1500 * 1024) { //about how far particles get in a render, then start over
+            for(int j = 0; j < 1024; j++) particles[j].pos = points[j];
+            steps = 0;
+        }
+        auto &p = particles[i++ & 1023];
+        p.update(f);
+        sink += p.pos.x;
+    });
+    bench("flow/sphereNoise", 1, [&] { sink += f.sphereNoise(points[i++ & 1023]).x; });
+    vector<ofVec3f> directions;
+    bench("flow/sphereNoise/batch", points.size(), [&] {
+        f.sphereNoise(points, directions);
+        sink += directions[0].x;
+    });
+    bench("flow/resolveFormula", 1, [&] { sink += f.resolveFormula(points[i++ & 1023]).x; });
+}
+
+void benchCamera() {
+    rng r;
+    r.seed(seed);
+    const int n = 1024;
+    vector<double> x(n), y(n), z(n), sx(n), sy(n), d(n), alpha(n);
+    vector<float> fx(n), fy(n), fz(n);
+    for(int i = 0; i < n; i++)
+        fx[i] = x[i] = r.random(-4, 4), fy[i] = y[i] = r.random(-4, 4), fz[i] = z[i] = r.random(-2, 6);
+    camera c(ofVec3f(0.01, -0.01, -4), 0.3, 2000, 2000);
+    c.glow = 0.2;
+    bench("camera/depthAndProject", n, [&] {
+        c.depthAndProject(n, x.data(), y.data(), z.data(), sx.data(), sy.data(), d.data(), alpha.data());
+        sink += sx[0];
+    });
+    bench("camera/depthAndProject/float points", n, [&] {
+        c.depthAndProject(n, fx.data(), fy.data(), fz.data(), sx.data(), sy.data(), d.data(), alpha.data());
+        sink += sx[0];
+    });
+    c.mult = true;
+    bench("camera/depthAndProject/mult", n, [&] {
+        c.depthAndProject(n, x.data(), y.data(), z.data(), sx.data(), sy.data(), d.data());
+        sink += sx[0];
+    });
+}
+
+void benchPalette() {
+    rng r;
+    r.seed(seed);
+    const int n = 1024;
+    vector<double> hue(n), sat(n);
+    for(int i = 0; i < n; i++) hue[i] = r.random(1), sat[i] = r.random(0.3, 0.8);
+    vector<ofFloatColor> out(n);
+    palette p;
+    bench("palette/setHsb", n, [&] {
+        for(int i = 0; i < n; i++) out[i].setHsb(hue[i], sat[i], 1);
+        sink += out[0].r;
+    });
+    bench("palette/lookup", n, [&] {
+        p.lookup(n, hue.data(), sat.data(), out.data());
+        sink += out[0].r;
+    });
+}
+
+void benchBorder() {
+    rng r;
+    r.seed(seed);
+    const int n = 1024;
+    vector<double> x(n), y(n);
+    for(int i = 0; i < n; i++) x[i] = r.random(-100, 2100), y[i] = r.random(-100, 2100); //about a third near an edge or outside
+    border b(2000, 2000);
+    int i = 0;
+    bench("border/gaussians", 1, [&] {
+        double xx = x[i & 1023], yy = y[i++ & 1023];
+        sink += (xx > 100+r.gaussian(0, 2) && xx < 1900+r.gaussian(0, 2) && yy > 100+r.gaussian(0, 2) && yy < 1900+r.gaussian(0, 2));
+    });
+    bench("border/stencil", 1, [&] {
+        double xx = x[i & 1023], yy = y[i++ & 1023];
+        sink += b.inside(r, xx, yy);
+    });
+}
+
+void benchFujii() {
+    fujii_sketch s;
+    s.rnd.seed(seed);
+    for(int i = 1; i <= 12; i++)
+        s.a[i] = s.random(0.7, 1.2) * (s.random(0, 100) > 50 ? -1: 1),
+        s.f[i] = s.random(0.7, 1.2) * (s.random(0, 100) > 50 ? -1: 1);
+    s.v = 0.0005;
+
+    for(int p = -5; p <= 5; p++) {
+        double x = 0;
+        bench("fujii/ssin/p=" + ofToString(p), 1, [&] { sink += ssin(x += 0.001, p); });
+        bench("fujii/ccos/p=" + ofToString(p), 1, [&] { sink += ccos(x += 0.001, p); });
+        s.p[1] = s.p[2] = p;
+        s.x = s.y = s.z = s.t = 0;
+        bench("fujii/next/p=" + ofToString(p), 1, [&] {
+            double xx, yy, zz;
+            s.next(xx, yy, zz);
+            s.t += s.v;
+            s.x = xx;
+            s.y = yy;
+            s.z = zz;
+            sink += xx;
+        });
+        s.x = s.y = s.z = s.t = 0;
+        bench("fujii/next/float/p=" + ofToString(p), 1, [&] { //ART_FLOAT
+            float xx, yy, zz;
+            s.next(xx, yy, zz);
+            s.t += s.v;
+            s.x = xx;
+            s.y = yy;
+            s.z = zz;
+            sink += xx;
+        });
+    }
+}
+
+void benchWalker() {
+    walker_sketch s;
+    s.rnd.seed(seed);
+    s.noise_seed = s.random(1000);
+    s.vis.assign(s.width, std::vector<int>(s.height, 0));
+    for(int i = 0; i < s.width * s.height / 10; i++) //a tenth of the canvas already drawn on
+        s.vis[(int)s.random(s.width)][(int)s.random(s.height)] = (int)s.random(1, 100);
+    s.angles = {45, 90};
+    s.randomiseParameters();
+
+    vector<walker> walkers;
+    for(int i = 0; i < 256; i++)
+        walkers.push_back(walker(s, s.random(s.width), s.random(s.height), (int)s.random(10)*s.angle(s.rnd), 0, i+1));
+
+    int i = 0;
+    auto keepInside = [&](walker &w) {
+        if(w.x < 0 || w.x >= s.width || w.y < 0 || w.y >= s.height)
+            w.x = s.random(s.width), w.y = s.random(s.height);
+    };
+    bench("walker/update", 1, [&] {
+        auto &w = walkers[i++ & 255];
+        sink += w.update(s);
+        keepInside(w);
+    });
+    bench("walker/blocked", 1, [&] { sink += s.blocked(walkers[i++ & 255]); });
+    bench("walker/update+blocked", 1, [&] {
+        auto &w = walkers[i++ & 255];
+        sink += w.update(s) + s.blocked(w);
+        keepInside(w);
+    });
+}
+
+void benchWatercolor() {
+    watercolor_sketch s;
+    s.rnd.seed(seed);
+    polygon base(s, s.rnd, s.height/2);
+    base.deform(s, s.rnd, 5);
+    int added = base.vertices.size() * 15; //four rounds, each doubling the vertices
+    bench("watercolor/polygon::deform", added, [&] {
+        polygon p = base;
+        p.deform(s, s.rnd, 4);
+        sink += p.vertices.back().second;
+    });
+    bench("watercolor/polygon::deform/float", added, [&] {
+        polygon p = base;
+        p.deform<float>(s, s.rnd, 4);
+        sink += p.vertices.back().second;
+    });
+}
+
+void benchCell() {
+    cell_sketch s;
+    s.rnd.seed(seed);
+    s.noise_seed = s.random(1000);
+    s.res = 300;
+    s.coord_scale = 2;
+    s.rnd_noise = 0.05;
+    for(int i = 0; i < 5; i++) s.rules.push_back(s.random(256));
+    s.states.assign(s.res, std::vector<int>(s.res, 0));
+    for(int x = 0; x < s.res; x++)
+        s.states[x][0] = (s.random(1) <= 0.5 ? 1 : 0);
+
+    int y = 0, x = 0;
+    bench("cell/evaluateRow", s.res, [&] {
+        y = y % (s.res - 1) + 1;
+        s.evaluateRow(y);
+        sink += s.states[0][y];
+    });
+    bench("cell/getState", 1, [&] {
+        x = (x + 1) % s.res;
+        sink += s.getState(s.rules[x % 5], x, y);
+    });
+}
+
+void benchHexgrid() {
+    if(!filter.empty() && string("hexgrid/drawCell").find(filter) == string::npos) return;
+    hexgrid_sketch s;
+    s.start(seed, std::make_unique<cpu_canvas>()); //draws one whole image to set everything up
+    int i = 0;
+    double step = s.grid_size;
+    int columns = s.width / step, rows = s.height / step;
+    bench("hexgrid/drawCell", 1, [&] {
+        if(i % 1024 == 0) s.points.clear();
+        s.drawCell(s.rnd, (i % columns) * step, (i / columns % rows) * step);
+        i++;
+    });
+}
+
+int main(int argc, char *argv[]){
+    string json;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-f" && i+1 < argc) filter = argv[++i];
+        else if(arg == "-t" && i+1 < argc) min_time = stod(argv[++i]);
+        else if(arg == "-json" && i+1 < argc) json = argv[++i];
+    }
+
+    benchRng();
+    benchNoise();
+    benchGrain();
+    benchEncode();
+    benchField();
+    benchFlow();
+    benchCamera();
+    benchPalette();
+    benchBorder();
+    benchFujii();
+    benchWalker();
+    benchWatercolor();
+    benchCell();
+    benchHexgrid();
+
+    if(!json.empty()) {
+        std::ofstream out(json);
+        out.precision(12);
+        out << "{\n  \"context\": {\"seed\": \"" << std::hex << seed << std::dec << "\", \"min_time\": " << min_time << "},\n";
+        out << "  \"benchmarks\": [\n";
+        for(int i = 0; i < results.size(); i++) {
+            auto &r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op << ", \"items_per_second\": " << r.items_per_second << "}"
+                << (i+1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+    return sink == 12345 ? 1 : 0; //never true in practice, keeps sink alive
+}
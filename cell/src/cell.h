@@ -0,0 +1,102 @@
+#pragma once
+
+//elementary cellular automata, the rule for every cell is picked by noise
+
+#include "../../common/sketch.h"
+#include "../../common/noise.h"
+
+struct cell_sketch : sketch {
+    cell_sketch() : sketch("cell", 2000, 2000, 3) {} //2: ziggurat gaussians, 3: philox streams
+
+    typeface *font;
+
+    int res = 300;
+    std::vector<std::vector<int> > states;
+
+    double noise_seed;
+    double coord_scale;
+    double rnd_noise;
+    std::vector<int> rules; //picked between by noise
+
+    bool finished = false; //everything is drawn in setup
+
+    int getState(int n, int x, int y) {
+        int l = 0, m, r = 0;
+        if(x > 0) l = states[x - 1][y];
+        if(x < res - 1) r = states[x + 1][y];
+        m = states[x][y];
+
+        int pos = (l << 2) + (m << 1) + r;
+        return (n >> pos) & 1;
+    }
+
+    std::vector<float> row_x, row_y; //noise coordinates of a row
+    std::vector<double> row_noise;
+
+    void evaluateRow(int y) { //every cell picks a rule by noise and applies it to the row above
+        row_x.resize(res), row_y.resize(res), row_noise.resize(res);
+        for(int x = 0; x < res; x++) {
+            row_x[x] = (double)x/res * coord_scale;
+            row_y[x] = (double)y/res * coord_scale;
+        }
+        noise::fbm(res, row_x.data(), row_y.data(), noise_seed, 4, row_noise.data());
+        for(int x = 0; x < res; x++) {
+            double n = min(1.0, row_noise[x] * gaussian(1, rnd_noise));
+            int ind = (rules.size() - 1) * n;
+            states[x][y] = getState(rules[ind], x, y - 1);
+        }
+    }
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+        noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+
+        res = random(150, 400);
+        int n = random(2, 8);
+        coord_scale = random(1, 3);
+        rnd_noise = random(0.001, 0.1);
+
+        rules = { (int)random(256) };
+        for(int i = 1; i < n; i++) rules.push_back(random(256));
+
+        states.assign(res, std::vector<int>(res, 0));
+        for(int x = 0; x < res; x++)
+            states[x][0] = (random(1) <= 0.5 ? 1 : 0);
+        for(int y = 1; y < res; y++)
+            evaluateRow(y);
+
+        buffer->begin();
+        buffer->background(ofColor(255));
+        buffer->setColor(ofColor(0));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        drawGrain(100, 100, width-199, height-199);
+
+        double cell_size = (width - 200.0)/res;
+        for(double y = 100, y_ind = 0; y_ind < res ; y += cell_size, y_ind++)
+            for(double x = 100, x_ind = 0; x_ind < res ; x += cell_size, x_ind++) {
+                //buffer->setColor(ofColor(states[(int)x_ind][(int)y_ind], states[(int)x_ind][(int)y_ind], states[(int)x_ind][(int)y_ind]));
+                buffer->setColor(ofColor(16, 16, 16));
+                if(states[(int)x_ind][(int)y_ind]) {
+                    buffer->drawRectangle(x, y, cell_size, cell_size);
+                }
+            }
+        buffer->end();
+        finished = true;
+    }
+
+    void update() {}
+
+    void describe(std::ostream &out) {
+        out << "noise_seed=" << noise_seed << "\n";
+        out << "res=" << res << "\n";
+        out << "coord_scale=" << coord_scale << "\n";
+        out << "rnd_noise=" << rnd_noise << "\n";
+        out << "rules=" << join(rules) << "\n";
+    }
+
+    bool done() {
+        return finished;
+    }
+};
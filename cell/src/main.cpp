@@ -1,10 +1,23 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "ofAppNoWindow.h"
 
 //========================================================================
 int main( ){
-    ofGLFWWindowSettings settings;
-    settings.visible = false; //uncomment to hide the window
-    ofCreateWindow(settings);
-    ofRunApp(new ofApp);
+    //ART_GL=1 renders through opengl in a window, ART_GL=hidden in one that isn't shown,
+    //otherwise on the cpu canvas with no window or gl context needed
+    const char *gl = getenv("ART_GL");
+    if(gl && *gl && string(gl) != "0") {
+        ofGLFWWindowSettings settings;
+        settings.visible = string(gl) != "hidden";
+        ofCreateWindow(settings);
+        ofRunApp(new ofApp);
+        return 0;
+    }
+    ofWindowSettings settings;
+    auto window = std::make_shared<ofAppNoWindow>();
+    window->setup(settings);
+    ofGetMainLoop()->addWindow(window);
+    ofRunApp(window, std::make_shared<ofApp>());
+    ofRunMainLoop();
 }
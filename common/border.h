@@ -0,0 +1,52 @@
+#pragma once
+
+//the rough edge field, flow, fujii and walker leave round the canvas, 100 pixels in
+//a point used to pass four tests against the margin moved by gaussian(0, 2) each, which lets it through
+//with the chance that all four gaussians fall on the right side of it: a product of normal cdfs of its
+//distances to the margins, one for each side, looked up in a table made once
+//points further than 6 deviations inside all four margins always pass and don't draw anything,
+//the rest draw one uniform against that chance, or nothing when it's 0
+//exact gaussians draw the four tests in order like version 1 did
+
+#include "rng.h"
+#include <cmath>
+#include <vector>
+
+struct border {
+    static constexpr int margin = 100;
+    static constexpr double deviation = 2;
+    static constexpr int reach = 12; //6 deviations, the chance is 0 or 1 this far from the margin
+    static constexpr int fraction = 16; //table entries to a pixel
+
+    int width, height;
+
+    border(int w, int h) : width(w), height(h) {}
+
+    //chance that margin+gaussian(0, deviation) is under margin+d, so d past a margin passes its test
+    static const std::vector<float> &profile() {
+        static const std::vector<float> p = [] {
+            std::vector<float> t(2 * reach * fraction + 1);
+            for(int i = 0; i < (int)t.size(); i++)
+                t[i] = 0.5 * erfc(-((double)i / fraction - reach) / (deviation * sqrt(2.0)));
+            return t;
+        }();
+        return p;
+    }
+
+    static double pass(double d) {
+        if(!(d > -reach)) return 0; //nan too, it never passed a comparison
+        if(d >= reach) return 1;
+        double x = (d + reach) * fraction;
+        int i = (int)x;
+        const float *p = &profile()[i];
+        return p[0] + (p[1] - p[0]) * (x - i);
+    }
+
+    bool inside(rng &r, double x, double y) const {
+        if(r.exact) return x > margin+r.gaussian(0, deviation) && x < width-margin+r.gaussian(0, deviation) &&
+                           y > margin+r.gaussian(0, deviation) && y < height-margin+r.gaussian(0, deviation);
+        if(x > margin+reach && x < width-margin-reach && y > margin+reach && y < height-margin-reach) return true;
+        double chance = pass(x-margin) * pass(width-margin-x) * pass(y-margin) * pass(height-margin-y);
+        return chance > 0 && r.uniform() < chance;
+    }
+};
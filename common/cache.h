@@ -0,0 +1,136 @@
+#pragma once
+
+//finished renders stored by a hash of everything that decides what they look like,
+//so a sweep that's run again only renders seeds it hasn't seen
+//  <key>.jpg  the image, and <key>.png with a png format
+//  <key>-1080.jpg  smaller copies, with sizes
+//  <key>.txt  its manifest, the sketch's parameters
+//  <key>.stats  timings and counts from when it was rendered
+//  <key>.trace.json  when tracing is on
+
+#include "sketch.h"
+#include "writer.h"
+#include <fstream>
+#include <iomanip>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+inline std::string renderKey(const sketch &s, int seed, long long budget) { //budget 0 is the sketch's own
+    std::stringstream in;
+    in << s.name << " " << s.version << " " << std::hex << (unsigned int)seed << std::dec << " " << s.width << "x" << s.height << " " << budget;
+    if(s.rnd.exact) in << " exact";
+    else if(grainClasses()) in << " grain " << grainClasses(); //every sketch, whether it has grain isn't known before it starts
+    if(s.single) in << " float";
+    uint64_t hash = 14695981039346656037ull; //64 bit fnv-1a, stable everywhere
+    for(unsigned char c : in.str()) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    std::stringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return out.str();
+}
+
+struct render_cache {
+    std::string dir;
+
+    render_cache(const std::string &_dir) : dir(_dir) {
+        mkdir(dir.c_str(), 0777);
+    }
+
+    std::string image(const std::string &key, const image_format &format) {
+        return dir + key + "." + format.ext;
+    }
+
+    std::string image(const std::string &key, int size, const image_format &format) {
+        return sizedPath(dir + key, size, format);
+    }
+
+    std::string checkpoint(const std::string &key) { //a render of key still in progress, see checkpoint.h
+        return dir + key + ".checkpoint";
+    }
+
+    //only when it's there in every format asked for, at the depth asked for, and every size
+    //a render cached without a size asked for now is rendered again
+    bool has(const std::string &key, const std::vector<image_format> &formats, const std::vector<int> &sizes = {}) {
+        for(auto &f : formats) {
+            if(!has(image(key, f), f)) return false;
+            for(int size : sizes)
+                if(!has(image(key, size, f), f)) return false;
+        }
+        return true;
+    }
+
+    static bool has(const std::string &path, const image_format &f) {
+        std::ifstream in(path, std::ios::binary);
+        if(!in) return false;
+        if(f.ext == "png" && (!in.seekg(24) || in.get() != f.depth)) return false; //the bit depth in IHDR
+        return true;
+    }
+
+    //written under temporary names and renamed, so a key is only there once it's complete,
+    //pix is what s read back from its canvas, this can run on a writer thread
+    bool store(sketch &s, const image_pixels &pix, const std::string &key, const std::string &manifest) {
+        std::string tmp = temporary(key);
+        if(!writeFile(tmp + ".txt", "key=" + key + "\n" + manifest)) return false;
+        if(!s.write(pix, tmp)) return false;
+        if(s.tracer.enabled) rename((tmp + ".trace.json").c_str(), (dir + key + ".trace.json").c_str());
+        rename((tmp + ".stats").c_str(), (dir + key + ".stats").c_str());
+        bool ok = true;
+        for(auto &f : s.formats) {
+            ok = rename((tmp + "." + f.ext).c_str(), image(key, f).c_str()) == 0 && ok;
+            for(int size : s.sizes) ok = rename(sizedPath(tmp, size, f).c_str(), image(key, size, f).c_str()) == 0 && ok;
+        }
+        return ok && rename((tmp + ".txt").c_str(), (dir + key + ".txt").c_str()) == 0 && syncPath(dir);
+    }
+
+    //unique to this store, two renders of one key can be running in one process or on two
+    //queue nodes sharing the cache, and pids alone can be the same on different machines
+    std::string temporary(const std::string &key) {
+        static std::atomic<int> count(0);
+        return dir + "." + key + "-" + hostName() + "-" + std::to_string(getpid()) + "-" + std::to_string(count++);
+    }
+
+    //put a cached image at base.<ext> for every format, its sizes at base-<size>.<ext>, and its stats next to them
+    bool place(const std::string &key, const std::string &base, const std::vector<image_format> &formats, const std::vector<int> &sizes = {}) {
+        struct stat st;
+        if(stat((dir + key + ".stats").c_str(), &st) == 0)
+            copy(dir + key + ".stats", base + ".stats");
+        bool ok = true;
+        for(auto &f : formats) {
+            ok = copy(image(key, f), base + "." + f.ext) && ok;
+            for(int size : sizes) ok = copy(image(key, size, f), sizedPath(base, size, f)) && ok;
+        }
+        return ok;
+    }
+
+    //as a hard link when it's on the same disk
+    static bool copy(const std::string &from, const std::string &to) {
+        std::string tmp = temporaryPath(to);
+        if(link(from.c_str(), tmp.c_str()) != 0) {
+            //someone else's temporary, maybe a link to a cached image, is never written over
+            if(errno == EEXIST) return false;
+            int out = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+            if(out < 0) return false;
+            std::ifstream in(from, std::ios::binary);
+            char buffer[1 << 16];
+            bool ok = (bool)in;
+            while(ok && in) {
+                in.read(buffer, sizeof(buffer));
+                ok = !in.bad() && (in.gcount() == 0 || write(out, buffer, in.gcount()) == in.gcount());
+            }
+            ok = close(out) == 0 && ok;
+            if(!ok) {
+                unlink(tmp.c_str());
+                return false;
+            }
+            return commitFile(tmp, to);
+        }
+        bool ok = rename(tmp.c_str(), to.c_str()) == 0;
+        unlink(tmp.c_str()); //rename leaves it when to was already this same file
+        return ok;
+    }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+//the camera field, flow and fujii look through, projecting many points at once
+//a point's distance from the camera divides its offset from it (or multiplies it, the mult look)
+//then it's scaled by width/fov onto the canvas, with the same double operations in the same order as
+//the sketches did one point at a time, so every seed looks the same
+//points can be floats like ofVec3f, then the offset and its ratio to the depth are worked out in float
+//like ofVec3f did, and double after that
+//4 points at a time with avx or sse2, one by one on anything else, define CAMERA_SCALAR to leave the simd out
+
+#include "ofMain.h"
+#include <algorithm>
+#if !defined(CAMERA_SCALAR) && (defined(__AVX__) || defined(__SSE2__) || defined(_M_X64))
+#define CAMERA_SIMD
+#include <immintrin.h>
+#endif
+
+namespace lens {
+
+namespace lanes1 {
+    struct vfloat { float v; vfloat() {} vfloat(float f) : v(f) {} };
+    struct vdouble { double v; vdouble() {} vdouble(double d) : v(d) {} };
+
+    inline vfloat operator-(vfloat a, vfloat b) { return a.v - b.v; }
+    inline vfloat operator/(vfloat a, vfloat b) { return a.v / b.v; }
+    inline vdouble operator+(vdouble a, vdouble b) { return a.v + b.v; }
+    inline vdouble operator-(vdouble a, vdouble b) { return a.v - b.v; }
+    inline vdouble operator*(vdouble a, vdouble b) { return a.v * b.v; }
+    inline vdouble operator/(vdouble a, vdouble b) { return a.v / b.v; }
+    inline vdouble sqrt(vdouble a) { return std::sqrt(a.v); }
+    inline vdouble max(vdouble a, vdouble b) { return std::max(a.v, b.v); }
+    inline vdouble widen(vfloat a) { return (double)a.v; }
+    inline vdouble widen(vdouble a) { return a; }
+    inline vfloat load(vfloat, const float *p) { return *p; }
+    inline vdouble load(vdouble, const double *p) { return *p; }
+    inline void store(double *p, vdouble a) { *p = a.v; }
+}
+
+#if defined(CAMERA_SIMD)
+namespace lanes4 {
+    struct vfloat { __m128 v; vfloat() {} vfloat(__m128 a) : v(a) {} vfloat(float f) : v(_mm_set1_ps(f)) {} };
+
+    inline vfloat operator-(vfloat a, vfloat b) { return _mm_sub_ps(a.v, b.v); }
+    inline vfloat operator/(vfloat a, vfloat b) { return _mm_div_ps(a.v, b.v); }
+    inline vfloat load(vfloat, const float *p) { return _mm_loadu_ps(p); }
+
+#if defined(__AVX__)
+    struct vdouble { __m256d v; vdouble() {} vdouble(__m256d a) : v(a) {} vdouble(double d) : v(_mm256_set1_pd(d)) {} };
+
+    inline vdouble operator+(vdouble a, vdouble b) { return _mm256_add_pd(a.v, b.v); }
+    inline vdouble operator-(vdouble a, vdouble b) { return _mm256_sub_pd(a.v, b.v); }
+    inline vdouble operator*(vdouble a, vdouble b) { return _mm256_mul_pd(a.v, b.v); }
+    inline vdouble operator/(vdouble a, vdouble b) { return _mm256_div_pd(a.v, b.v); }
+    inline vdouble sqrt(vdouble a) { return _mm256_sqrt_pd(a.v); }
+    inline vdouble max(vdouble a, vdouble b) { return _mm256_max_pd(b.v, a.v); } //a when they're equal or either is nan, like std::max
+    inline vdouble widen(vfloat a) { return _mm256_cvtps_pd(a.v); }
+    inline vdouble load(vdouble, const double *p) { return _mm256_loadu_pd(p); }
+    inline void store(double *p, vdouble a) { _mm256_storeu_pd(p, a.v); }
+#else
+    struct vdouble { //two halves, sse2 has 2 doubles to a register
+        __m128d lo, hi;
+        vdouble() {}
+        vdouble(__m128d a, __m128d b) : lo(a), hi(b) {}
+        vdouble(double d) : lo(_mm_set1_pd(d)), hi(_mm_set1_pd(d)) {}
+    };
+
+    inline vdouble operator+(vdouble a, vdouble b) { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+    inline vdouble operator-(vdouble a, vdouble b) { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+    inline vdouble operator*(vdouble a, vdouble b) { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+    inline vdouble operator/(vdouble a, vdouble b) { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+    inline vdouble sqrt(vdouble a) { return {_mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi)}; }
+    inline vdouble max(vdouble a, vdouble b) { return {_mm_max_pd(b.lo, a.lo), _mm_max_pd(b.hi, a.hi)}; }
+    inline vdouble widen(vfloat a) { return {_mm_cvtps_pd(a.v), _mm_cvtps_pd(_mm_movehl_ps(a.v, a.v))}; }
+    inline vdouble load(vdouble, const double *p) { return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)}; }
+    inline void store(double *p, vdouble a) { _mm_storeu_pd(p, a.lo); _mm_storeu_pd(p + 2, a.hi); }
+#endif
+
+    inline vdouble widen(vdouble a) { return a; }
+}
+#endif
+
+//the same for every width, lanes is a vfloat or vdouble of it, whichever the points are
+template<typename F>
+void run(int n, F f) {
+    int i = 0;
+#if defined(CAMERA_SIMD)
+    for(; i + 4 <= n; i += 4) f(lanes4::vdouble(), lanes4::vfloat(), i);
+#endif
+    for(; i < n; i++) f(lanes1::vdouble(), lanes1::vfloat(), i);
+}
+
+}
+
+struct camera {
+    ofVec3f pos;
+    double fov = 1;
+    int width = 0, height = 0;
+    bool mult = false; //multiplies by the distance instead of dividing, the wrong 3d that looks cool
+    bool divide = false; //divides by the distance rather than multiplying by one over it, as flow always has
+    double glow = 0, near = 0; //a point's alpha is glow / max(near, distance)
+
+    camera() {}
+    camera(ofVec3f _pos, double _fov, int w, int h, bool _mult = false) :
+        pos(_pos), fov(_fov), width(w), height(h), mult(_mult) {}
+
+    //distance from the camera of n points, and their alpha when it's wanted
+    template<typename T>
+    void depth(int n, const T *x, const T *y, const T *z, double *d, double *alpha = nullptr) const {
+        lens::run(n, [&](auto vd, auto vf, int i) {
+            auto lanes = pick(vd, vf, (T *)nullptr);
+            auto dd = distance(vd, load(lanes, x + i), load(lanes, y + i), load(lanes, z + i), (T)pos.x, (T)pos.y, (T)pos.z);
+            store(d + i, dd);
+            if(alpha) store(alpha + i, decltype(vd)(glow) / max(decltype(vd)(near), dd));
+        });
+    }
+
+    //where n points land on the canvas, each at the distance in d, which needn't be its own:
+    //field blurs points around a center and takes the center's
+    template<typename T>
+    void project(int n, const T *x, const T *y, const T *z, const double *d, double *sx, double *sy) const {
+        lens::run(n, [&](auto vd, auto vf, int i) {
+            auto lanes = pick(vd, vf, (T *)nullptr);
+            auto dd = load(vd, d + i);
+            store(sx + i, screen(load(lanes, x + i), load(lanes, z + i), dd, (T)pos.x, (T)pos.z, pos.x, width));
+            store(sy + i, screen(load(lanes, y + i), load(lanes, z + i), dd, (T)pos.y, (T)pos.z, pos.y, height));
+        });
+    }
+
+    //both, each point at its own distance
+    template<typename T>
+    void depthAndProject(int n, const T *x, const T *y, const T *z, double *sx, double *sy, double *d, double *alpha = nullptr) const {
+        depth(n, x, y, z, d, alpha);
+        project(n, x, y, z, d, sx, sy);
+    }
+
+private:
+    template<typename D, typename F> static F pick(D, F f, float *) { return f; }
+    template<typename D, typename F> static D pick(D d, F, double *) { return d; }
+
+    //sqrt(pow(x-cam.x, 2)+pow(y-cam.y, 2)+pow(z-cam.z, 2)), the differences in the points' precision
+    template<typename D, typename V, typename T>
+    static D distance(D, V x, V y, V z, T cx, T cy, T cz) {
+        D dx = widen(x - V(cx)), dy = widen(y - V(cy)), dz = widen(z - V(cz));
+        return sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    //((v-cam)/(z-cam.z)*(mult ? d : 1/d)+cam)*size/fov+size/2
+    template<typename D, typename V, typename T>
+    D screen(V v, V z, D d, T c, T cz, double cam, int size) const {
+        D ratio = widen((v - V(c)) / (z - V(cz)));
+        D k = (mult ? ratio * d : (divide ? ratio / d : ratio * (D(1.0) / d)));
+        return (k + D(cam)) * D(size) / D(fov) + D(size / 2);
+    }
+};
@@ -0,0 +1,624 @@
+#pragma once
+
+//drawing surface the sketches plot into
+//cpu_canvas is a plain float rgba array in memory, it needs no window or gl context,
+//or with sparse set, tiles of one made as they're drawn on
+//fbo_canvas is the old opengl path through an ofFbo, used when running with a window,
+//with points and rectangles batched into a draw call
+//both follow openframeworks' conventions for colors, blend modes and pixel coverage
+
+#include "ofMain.h"
+#include "typeface.h"
+#include "checkpoint.h"
+
+struct canvas {
+    int width = 0, height = 0;
+
+    virtual ~canvas() {}
+    virtual void allocate(int w, int h) = 0;
+    virtual void begin() {}
+    virtual void end() {}
+
+    virtual void background(const ofFloatColor &c) = 0;
+    virtual void setColor(const ofFloatColor &c) = 0;
+    virtual void enableBlendMode(ofBlendMode mode) = 0;
+    virtual void fill() = 0;
+    virtual void noFill() = 0;
+
+    virtual void pushMatrix() = 0;
+    virtual void popMatrix() = 0;
+    virtual void translate(double x, double y) = 0;
+    virtual void scale(double x, double y) = 0;
+    virtual void rotateDeg(double degrees) = 0;
+
+    virtual void drawPoint(double x, double y) = 0; //1x1 splat
+    virtual void drawRectangle(double x, double y, double w, double h) = 0;
+    virtual void drawLine(double x1, double y1, double x2, double y2) = 0;
+    virtual void drawBezier(double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3) = 0;
+    virtual void drawShape(const std::vector<ofVec2f> &vertices) = 0; //filled, odd winding
+    virtual void drawString(typeface &font, const std::string &s, double x, double y) = 0;
+    virtual void drawSelf() = 0; //draw the canvas onto itself with the current color and blend mode
+
+    //a w*h block of grey levels, row by row, each drawn as a point of that grey with the given alpha
+    virtual void drawShades(const unsigned char *shades, int x, int y, int w, int h, int alpha) {
+        for(int j = 0; j < h; j++)
+            for(int i = 0; i < w; i++) {
+                int shade = shades[(size_t)j * w + i];
+                setColor(ofColor(shade, shade, shade, alpha));
+                drawPoint(x + i, y + j);
+            }
+    }
+
+    virtual void readToPixels(ofPixels &pix) = 0;
+    virtual void readToPixels(ofShortPixels &pix) = 0; //16 bits a channel, for png16
+    virtual void draw(double x, double y) = 0; //preview in the window, if there is one
+
+    //the pixels and drawing state, for checkpoints, false when they can't be had
+    virtual bool persist(archive &a) { return false; } //an fbo's pixels live on the gpu
+};
+
+struct cpu_canvas : canvas {
+    ofFloatPixels pixels;
+
+    //set before allocate to keep the pixels in tiles that are only made when something is first
+    //drawn on them, the rest are all the background, so a big print of a sketch that covers a
+    //little of it needs memory for what it covers
+    bool sparse = false;
+    static constexpr int tile_bits = 6; //64x64 pixels
+    std::vector<std::unique_ptr<float[]> > tiles; //row by row, null until touched
+    float blank[4] = {0, 0, 0, 0}; //every pixel of a tile that hasn't been made
+
+    void allocate(int w, int h) {
+        width = w;
+        height = h;
+        if(sparse) {
+            across = (w + (1 << tile_bits) - 1) >> tile_bits;
+            tiles.clear();
+            tiles.resize((size_t)across * ((h + (1 << tile_bits) - 1) >> tile_bits));
+            std::fill(blank, blank + 4, 0);
+        }
+        else {
+            pixels.allocate(w, h, OF_PIXELS_RGBA);
+            pixels.set(0);
+        }
+        //a reused canvas starts over like a fresh one
+        color = ofFloatColor(1, 1, 1, 1);
+        mode = OF_BLENDMODE_ALPHA;
+        filled = true;
+        m = transform();
+        stack.clear();
+    }
+
+    void background(const ofFloatColor &c) {
+        if(sparse) {
+            for(auto &t : tiles) t.reset();
+            blank[0] = c.r, blank[1] = c.g, blank[2] = c.b, blank[3] = 1;
+            return;
+        }
+        float *p = pixels.getData();
+        for(size_t i = 0, n = (size_t)width * height; i < n; i++, p += 4)
+            p[0] = c.r, p[1] = c.g, p[2] = c.b, p[3] = 1;
+    }
+
+    void setColor(const ofFloatColor &c) { color = c; }
+    void enableBlendMode(ofBlendMode m) { mode = m; }
+    void fill() { filled = true; }
+    void noFill() { filled = false; }
+
+    void pushMatrix() { stack.push_back(m); }
+    void popMatrix() {
+        if(stack.empty()) return;
+        m = stack.back();
+        stack.pop_back();
+    }
+    void translate(double x, double y) {
+        m.tx += m.a * x + m.c * y;
+        m.ty += m.b * x + m.d * y;
+    }
+    void scale(double x, double y) {
+        m.a *= x, m.b *= x;
+        m.c *= y, m.d *= y;
+    }
+    void rotateDeg(double degrees) {
+        double s = sin(degrees * DEG_TO_RAD), co = cos(degrees * DEG_TO_RAD);
+        transform r = m;
+        m.a = r.a * co + r.c * s;
+        m.b = r.b * co + r.d * s;
+        m.c = r.c * co - r.a * s;
+        m.d = r.d * co - r.b * s;
+    }
+
+    //a unit square starting at x covers the pixel whose center lies in [x, x+1)
+    void drawPoint(double x, double y) {
+        if(!m.identity()) m.apply(x, y);
+        int px = ceil(x - 0.5), py = ceil(y - 0.5);
+        if(px < 0 || py < 0 || px >= width || py >= height) return;
+        blend(pixel(px, py), 1);
+    }
+
+    void drawRectangle(double x, double y, double w, double h) {
+        if(m.b != 0 || m.c != 0) { //rotated, rasterize as a polygon
+            drawShape({ofVec2f(x, y), ofVec2f(x + w, y), ofVec2f(x + w, y + h), ofVec2f(x, y + h)});
+            return;
+        }
+        double x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+        m.apply(x0, y0);
+        m.apply(x1, y1);
+        if(x0 > x1) std::swap(x0, x1);
+        if(y0 > y1) std::swap(y0, y1);
+        int px0 = std::max(0, (int)ceil(x0 - 0.5)), px1 = std::min(width, (int)ceil(x1 - 0.5));
+        int py0 = std::max(0, (int)ceil(y0 - 0.5)), py1 = std::min(height, (int)ceil(y1 - 0.5));
+        for(int py = py0; py < py1; py++)
+            for(int px = px0, n; px < px1; px += n) {
+                float *p = span(px, py, px1 - px, n);
+                for(int i = 0; i < n; i++, p += 4)
+                    blend(p, 1);
+            }
+    }
+
+    void drawLine(double x1, double y1, double x2, double y2) {
+        std::vector<ofVec2f> line = {ofVec2f(x1, y1), ofVec2f(x2, y2)};
+        stroke(line);
+    }
+
+    void drawBezier(double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3) {
+        std::vector<ofVec2f> curve;
+        for(int i = 0; i <= curve_resolution; i++) {
+            double t = (double)i / curve_resolution, u = 1 - t;
+            curve.push_back(ofVec2f(
+                u*u*u*x0 + 3*u*u*t*x1 + 3*u*t*t*x2 + t*t*t*x3,
+                u*u*u*y0 + 3*u*u*t*y1 + 3*u*t*t*y2 + t*t*t*y3));
+        }
+        if(filled) drawShape(curve);
+        else stroke(curve);
+    }
+
+    void drawShape(const std::vector<ofVec2f> &vertices) {
+        std::vector<std::vector<ofVec2f> > contours = {vertices};
+        for(auto &v : contours[0]) apply(v);
+        fillPolygon(contours, 1);
+    }
+
+    void drawString(typeface &font, const std::string &s, double x, double y) {
+        double pen = 0;
+        for(unsigned code : typeface::decode(s)) {
+            const typeface::glyph &g = font.getGlyph(code);
+            if(g.width && g.height) stamp(g, x + pen + g.left, y - g.top);
+            pen += g.advance;
+        }
+    }
+
+    void drawSelf() {
+        ofFloatColor c = color;
+        auto self = [&](float *p, size_t n) {
+            for(size_t i = 0; i < n; i++, p += 4) {
+                color = ofFloatColor(p[0] * c.r, p[1] * c.g, p[2] * c.b, c.a);
+                blend(p, 1);
+            }
+        };
+        if(sparse) { //the tiles that have been made, and the background the rest share
+            for(auto &t : tiles)
+                if(t) self(t.get(), 1 << (2 * tile_bits));
+            self(blank, 1);
+        }
+        else self(pixels.getData(), (size_t)width * height);
+        color = c;
+    }
+
+    //straight into the pixels when nothing is transformed, same arithmetic as blend()
+    void drawShades(const unsigned char *shades, int x, int y, int w, int h, int alpha) {
+        if(!m.identity() || mode != OF_BLENDMODE_ALPHA || w <= 0 || h <= 0) {
+            canvas::drawShades(shades, x, y, w, h, alpha);
+            return;
+        }
+        float grey[256], a = ofFloatColor(ofColor(0, 0, 0, alpha)).a;
+        for(int i = 0; i < 256; i++) grey[i] = ofFloatColor(ofColor(i, i, i, alpha)).r;
+        int x0 = std::max(0, -x), x1 = std::min(w, width - x);
+        for(int j = std::max(0, -y); j < std::min(h, height - y); j++) {
+            const unsigned char *s = shades + (size_t)j * w;
+            for(int i = x0, n; i < x1; i += n) {
+                float *p = span(x + i, y + j, x1 - i, n);
+                for(int k = i; k < i + n; k++, p += 4) {
+                    float g = grey[s[k]];
+                    p[0] = g * a + p[0] * (1 - a);
+                    p[1] = g * a + p[1] * (1 - a);
+                    p[2] = g * a + p[2] * (1 - a);
+                    p[3] = a + p[3] * (1 - a);
+                }
+            }
+        }
+        int last = shades[(size_t)w * h - 1]; //where drawing them one at a time would leave the color
+        color = ofColor(last, last, last, alpha);
+    }
+
+    void readToPixels(ofPixels &pix) {
+        pix.allocate(width, height, OF_PIXELS_RGB);
+        for(int y = 0; y < height; y++) readRow(y, pix.getData() + (size_t)y * width * 3);
+    }
+
+    void readToPixels(ofShortPixels &pix) {
+        pix.allocate(width, height, OF_PIXELS_RGB);
+        for(int y = 0; y < height; y++) readRow(y, pix.getData() + (size_t)y * width * 3);
+    }
+
+    //one row as rgb at 8 or 16 bits, for images too big to read back whole (see tiles.h)
+    //the background where no tile was made is converted once and copied across
+    template<typename T>
+    void readRow(int y, T *q) {
+        float top = std::numeric_limits<T>::max();
+        T background[3];
+        for(int c = 0; c < 3; c++) background[c] = ofClamp(blank[c], 0, 1) * top + 0.5;
+        eachSpan(y, [&](int x, int n, const float *p) {
+            T *o = q + (size_t)x * 3;
+            if(!p) {
+                for(int i = 0; i < n; i++, o += 3) std::copy(background, background + 3, o);
+                return;
+            }
+            for(int i = 0; i < n; i++, o += 3, p += 4)
+                for(int c = 0; c < 3; c++)
+                    o[c] = ofClamp(p[c], 0, 1) * top + 0.5;
+        });
+    }
+
+    //f(x, n, pixels) for the runs of a row that lie in one tile each, left to right,
+    //pixels is null for a tile that was never made, a canvas that isn't sparse is one run
+    template<typename F>
+    void eachSpan(int y, F f) const {
+        if(!sparse) {
+            f(0, width, pixels.getData() + 4 * (size_t)y * width);
+            return;
+        }
+        int size = 1 << tile_bits, mask = size - 1;
+        const auto *row = &tiles[(size_t)(y >> tile_bits) * across];
+        for(int x = 0, t = 0; x < width; x += size, t++) {
+            int n = std::min(size, width - x);
+            f(x, n, row[t] ? row[t].get() + 4 * ((y & mask) << tile_bits) : nullptr);
+        }
+    }
+
+    double occupied() const { //how much of a sparse canvas has been made
+        if(!sparse || tiles.empty()) return 1;
+        size_t made = 0;
+        for(auto &t : tiles) made += (t != nullptr);
+        return (double)made / tiles.size();
+    }
+
+    void draw(double x, double y) {
+        if(!ofGetGLRenderer()) return;
+        ofPixels pix;
+        readToPixels(pix);
+        if(!preview.isAllocated()) preview.allocate(pix);
+        preview.loadData(pix);
+        preview.draw(x, y);
+    }
+
+    bool persist(archive &a) { //every float as it is, so a resumed render carries on exactly
+        if(sparse) return false; //only prints are sparse and they aren't checkpointed
+        int w = width, h = height;
+        a.io(w, h);
+        if(a.loading && (w != width || h != height)) allocate(w, h);
+        a.bytes(pixels.getData(), (size_t)width * height * 4 * sizeof(float));
+        a.io(color.r, color.g, color.b, color.a, mode, filled, m, stack);
+        return true;
+    }
+
+protected:
+    struct transform {
+        double a = 1, b = 0, c = 0, d = 1, tx = 0, ty = 0;
+        bool identity() const { return a == 1 && b == 0 && c == 0 && d == 1 && tx == 0 && ty == 0; }
+        void apply(double &x, double &y) const {
+            double xx = a * x + c * y + tx;
+            y = b * x + d * y + ty;
+            x = xx;
+        }
+    };
+
+    const int curve_resolution = 20; //ofDrawBezier's default
+    const int aa_samples = 4; //per axis, for lines and text
+
+    ofFloatColor color = ofFloatColor(1, 1, 1, 1);
+    ofBlendMode mode = OF_BLENDMODE_ALPHA;
+    bool filled = true;
+    transform m;
+    std::vector<transform> stack;
+    ofTexture preview;
+
+    int across = 0; //tiles in a row
+
+    float *pixel(int x, int y) {
+        int n;
+        return span(x, y, 1, n);
+    }
+
+    //up to want pixels from x along row y that lie next to each other, n says how many
+    float *span(int x, int y, int want, int &n) {
+        if(!sparse) {
+            n = want;
+            return pixels.getData() + 4 * ((size_t)y * width + x);
+        }
+        int size = 1 << tile_bits, mask = size - 1;
+        n = std::min(want, size - (x & mask));
+        auto &t = tiles[(size_t)(y >> tile_bits) * across + (x >> tile_bits)];
+        if(!t) {
+            t.reset(new float[4 * size * size]);
+            for(int i = 0; i < size * size; i++) std::copy(blank, blank + 4, &t[4 * i]);
+        }
+        return t.get() + 4 * (((y & mask) << tile_bits) + (x & mask));
+    }
+
+    void apply(ofVec2f &v) {
+        double x = v.x, y = v.y;
+        m.apply(x, y);
+        v = ofVec2f(x, y);
+    }
+
+    //blend the current color into one pixel, cover is the fraction of the pixel covered
+    void blend(float *p, float cover) {
+        float a = color.a * cover;
+        switch(mode) {
+            case OF_BLENDMODE_ADD: //GL_SRC_ALPHA, GL_ONE
+                p[0] += color.r * a;
+                p[1] += color.g * a;
+                p[2] += color.b * a;
+                p[3] = std::min(1.0f, p[3] + a);
+                break;
+            case OF_BLENDMODE_MULTIPLY: //GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA
+                p[0] *= 1 + cover * (color.r - color.a);
+                p[1] *= 1 + cover * (color.g - color.a);
+                p[2] *= 1 + cover * (color.b - color.a);
+                break;
+            case OF_BLENDMODE_DISABLED:
+                p[0] = color.r, p[1] = color.g, p[2] = color.b, p[3] = color.a;
+                break;
+            default: //GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA
+                p[0] = color.r * a + p[0] * (1 - a);
+                p[1] = color.g * a + p[1] * (1 - a);
+                p[2] = color.b * a + p[2] * (1 - a);
+                p[3] = a + p[3] * (1 - a);
+        }
+    }
+
+    //1 pixel wide antialiased polyline, each segment is a thin quad
+    void stroke(std::vector<ofVec2f> line) {
+        for(auto &v : line) apply(v);
+        for(size_t i = 0; i + 1 < line.size(); i++) {
+            ofVec2f a = line[i], b = line[i + 1];
+            double dx = b.x - a.x, dy = b.y - a.y, len = sqrt(dx*dx + dy*dy);
+            if(len == 0) continue;
+            ofVec2f n(-dy / len * 0.5, dx / len * 0.5);
+            std::vector<std::vector<ofVec2f> > quad = {{a + n, b + n, b - n, a - n}};
+            fillPolygon(quad, aa_samples);
+        }
+    }
+
+    //scanline fill with odd winding, samples*samples coverage samples per pixel
+    //samples = 1 samples pixel centers only, which is what gl does without multisampling
+    void fillPolygon(const std::vector<std::vector<ofVec2f> > &contours, int samples) {
+        struct edge { double x0, y0, x1, y1; };
+        std::vector<edge> edges;
+        double miny = 1e18, maxy = -1e18;
+        for(auto &c : contours)
+            for(size_t i = 0; i < c.size(); i++) {
+                ofVec2f a = c[i], b = c[(i + 1) % c.size()];
+                if(a.y == b.y) continue;
+                if(a.y > b.y) std::swap(a, b);
+                edges.push_back({a.x, a.y, b.x, b.y});
+                miny = std::min(miny, (double)a.y);
+                maxy = std::max(maxy, (double)b.y);
+            }
+        if(edges.empty()) return;
+        std::sort(edges.begin(), edges.end(), [](const edge &a, const edge &b) { return a.y0 < b.y0; });
+
+        int row0 = std::max(0, (int)floor(miny)), row1 = std::min(height - 1, (int)ceil(maxy));
+        std::vector<int> cover(width + 1, 0);
+        std::vector<const edge *> active;
+        std::vector<double> xs;
+        size_t next = 0;
+        int full = samples, limit = width * samples;
+
+        for(int row = row0; row <= row1; row++) {
+            int minx = width, maxx = -1;
+            for(int s = 0; s < samples; s++) {
+                double sy = row + (s + 0.5) / samples;
+                while(next < edges.size() && edges[next].y0 <= sy) active.push_back(&edges[next++]);
+                active.erase(std::remove_if(active.begin(), active.end(), [sy](const edge *e) { return e->y1 <= sy; }), active.end());
+                xs.clear();
+                for(auto e : active)
+                    if(e->y0 <= sy) xs.push_back(e->x0 + (sy - e->y0) * (e->x1 - e->x0) / (e->y1 - e->y0));
+                std::sort(xs.begin(), xs.end());
+                for(size_t i = 0; i + 1 < xs.size(); i += 2) {
+                    //sub-columns whose centers lie in [xs[i], xs[i+1])
+                    int k0 = std::max(0, (int)ceil(xs[i] * samples - 0.5));
+                    int k1 = std::min(limit, (int)ceil(xs[i + 1] * samples - 0.5));
+                    if(k0 >= k1) continue;
+                    int p0 = k0 / samples, p1 = (k1 - 1) / samples;
+                    minx = std::min(minx, p0);
+                    maxx = std::max(maxx, p1);
+                    if(p0 == p1) {
+                        cover[p0] += k1 - k0;
+                        continue;
+                    }
+                    cover[p0] += full * (p0 + 1) - k0;
+                    for(int p = p0 + 1; p < p1; p++) cover[p] += full;
+                    cover[p1] += k1 - full * p1;
+                }
+            }
+            if(maxx < 0) continue;
+            for(int x = minx; x <= maxx; x++) {
+                if(cover[x]) blend(pixel(x, row), (float)cover[x] / (samples * samples));
+                cover[x] = 0;
+            }
+        }
+    }
+
+    //draw a glyph bitmap with its top left corner at (x, y), through the current transform
+    void stamp(const typeface::glyph &g, double x, double y) {
+        double det = m.a * m.d - m.b * m.c;
+        if(det == 0) return;
+        double minx = 1e18, maxx = -1e18, miny = 1e18, maxy = -1e18;
+        for(int i = 0; i < 4; i++) {
+            double cx = x + (i & 1 ? g.width : 0), cy = y + (i & 2 ? g.height : 0);
+            m.apply(cx, cy);
+            minx = std::min(minx, cx), maxx = std::max(maxx, cx);
+            miny = std::min(miny, cy), maxy = std::max(maxy, cy);
+        }
+        int px0 = std::max(0, (int)floor(minx)), px1 = std::min(width - 1, (int)ceil(maxx));
+        int py0 = std::max(0, (int)floor(miny)), py1 = std::min(height - 1, (int)ceil(maxy));
+        auto sample = [&](int u, int v) -> float {
+            if(u < 0 || v < 0 || u >= g.width || v >= g.height) return 0;
+            return g.bitmap[v * g.width + u] / 255.0f;
+        };
+        for(int py = py0; py <= py1; py++)
+            for(int px = px0; px <= px1; px++) {
+                //inverse transform of the pixel center into bitmap space, then bilinear lookup
+                double dx = px + 0.5 - m.tx, dy = py + 0.5 - m.ty;
+                double u = (m.d * dx - m.c * dy) / det - x - 0.5;
+                double v = (m.a * dy - m.b * dx) / det - y - 0.5;
+                int u0 = floor(u), v0 = floor(v);
+                double fu = u - u0, fv = v - v0;
+                float cover = (sample(u0, v0) * (1 - fu) + sample(u0 + 1, v0) * fu) * (1 - fv) +
+                              (sample(u0, v0 + 1) * (1 - fu) + sample(u0 + 1, v0 + 1) * fu) * fv;
+                if(cover > 0) blend(pixel(px, py), cover);
+            }
+    }
+};
+
+struct fbo_canvas : canvas {
+    ofFbo fbo;
+    int internal = GL_RGBA; //GL_RGBA16 keeps more than 8 bits through the blending, for png16
+
+    //filled points and rectangles go into one mesh instead of an ofDrawRectangle each, and the mesh is
+    //drawn in one call at end, before anything else is drawn or the blend mode, fill or matrix change,
+    //and every batch_limit rectangles. they're the same two triangles ofDrawRectangle draws, in the
+    //same order, so the pixels come out the same
+    ofVboMesh batch;
+    static constexpr int batch_limit = 1 << 16;
+    int batched = 0;
+    ofColor color = ofColor(255); //what ofSetColor would leave, 8 bits a channel
+    bool color_set = false; //ofSetColor has been called with color, only needed for what isn't batched
+    ofBlendMode mode = OF_BLENDMODE_ALPHA;
+    bool mode_set = false;
+    bool filled = true;
+
+    void allocate(int w, int h) {
+        width = w;
+        height = h;
+        fbo.allocate(w, h, internal);
+        batch.setMode(OF_PRIMITIVE_TRIANGLES);
+        batch.setUsage(GL_STREAM_DRAW); //filled again every frame
+    }
+    void begin() { fbo.begin(); }
+    void end() {
+        flush();
+        fbo.end();
+    }
+
+    void flush() {
+        if(!batched) return;
+        batch.draw();
+        batch.clear();
+        batched = 0;
+        color_set = false; //drawing with a color per vertex leaves the current color undefined
+    }
+    void apply() { //before drawing something that goes by ofSetColor
+        flush();
+        if(!color_set) ofSetColor(color);
+        color_set = true;
+    }
+    void quad(double x, double y, double w, double h) {
+        ofFloatColor c = color;
+        ofIndexType i = batch.getNumVertices();
+        batch.addVertex(ofVec3f(x, y, 0));
+        batch.addVertex(ofVec3f(x + w, y, 0));
+        batch.addVertex(ofVec3f(x + w, y + h, 0));
+        batch.addVertex(ofVec3f(x, y + h, 0));
+        for(int k = 0; k < 4; k++) batch.addColor(c);
+        for(int k : {0, 1, 2, 0, 2, 3}) batch.addIndex(i + k); //the triangle fan ofDrawRectangle draws
+        if(++batched >= batch_limit) flush();
+    }
+
+    void background(const ofFloatColor &c) {
+        flush();
+        ofBackground(c);
+    }
+    void setColor(const ofFloatColor &c) {
+        ofColor q = c;
+        if(color_set && q == color) return;
+        color = q;
+        color_set = false;
+    }
+    void enableBlendMode(ofBlendMode m) {
+        if(mode_set && m == mode) return; //the sketches set it for every point
+        flush();
+        ofEnableBlendMode(m);
+        mode = m;
+        mode_set = true;
+    }
+    void fill() {
+        flush();
+        ofFill();
+        filled = true;
+    }
+    void noFill() {
+        flush();
+        ofNoFill();
+        filled = false;
+    }
+
+    void pushMatrix() { flush(); ofPushMatrix(); }
+    void popMatrix() { flush(); ofPopMatrix(); }
+    void translate(double x, double y) { flush(); ofTranslate(x, y); }
+    void scale(double x, double y) { flush(); ofScale(x, y); }
+    void rotateDeg(double degrees) { flush(); ofRotateDeg(degrees); }
+
+    void drawPoint(double x, double y) { drawRectangle(x, y, 1, 1); }
+    void drawRectangle(double x, double y, double w, double h) {
+        if(filled) quad(x, y, w, h);
+        else {
+            apply();
+            ofDrawRectangle(x, y, w, h);
+        }
+    }
+    void drawLine(double x1, double y1, double x2, double y2) {
+        apply();
+        ofDrawLine(x1, y1, x2, y2);
+    }
+    void drawBezier(double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3) {
+        apply();
+        ofDrawBezier(x0, y0, x1, y1, x2, y2, x3, y3);
+    }
+    void drawShape(const std::vector<ofVec2f> &vertices) {
+        apply();
+        ofBeginShape();
+        for(auto &v : vertices)
+            ofVertex(v.x, v.y);
+        ofEndShape();
+    }
+    void drawString(typeface &font, const std::string &s, double x, double y) {
+        apply();
+        font.gl().drawString(s, x, y);
+    }
+    void drawSelf() {
+        apply();
+        fbo.draw(0, 0);
+    }
+
+    void readToPixels(ofPixels &pix) { flush(); fbo.readToPixels(pix); }
+    void readToPixels(ofShortPixels &pix) { flush(); fbo.readToPixels(pix); }
+    void draw(double x, double y) {
+        flush();
+        fbo.draw(x, y);
+        color_set = mode_set = false; //the window's drawing goes on from here
+    }
+};
+
+//cpu canvas when running headless, the fbo when there is an opengl window to draw into
+//deep gives the fbo 16 bits a channel, the cpu canvas is always float
+inline std::unique_ptr<canvas> makeCanvas(bool deep = false) {
+    if(ofGetGLRenderer()) {
+        auto fbo = new fbo_canvas();
+        if(deep) fbo->internal = GL_RGBA16;
+        return std::unique_ptr<canvas>(fbo);
+    }
+    return std::unique_ptr<canvas>(new cpu_canvas());
+}
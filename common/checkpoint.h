@@ -0,0 +1,130 @@
+#pragma once
+
+//a render's state, to carry on with it after the process is gone
+//setup only depends on the seed, so a checkpoint holds what's changed since:
+//the canvas, the random streams, counters and whatever else each sketch's update moves on
+//the same code writes and reads it, a type with more than plain bytes in it says what it's made of with
+//  void persist(archive &a) { a.io(x, y, children); }
+//files are deflated and written under a temporary name, so there's always a whole one
+
+#include "writer.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <zlib.h>
+
+struct archive {
+    const bool loading;
+    std::string data;
+    size_t pos = 0;
+
+    archive(bool _loading) : loading(_loading) {}
+
+    template<typename... T>
+    void io(T &... v) {
+        int each[] = {0, (one(v), 0)...};
+        (void)each;
+    }
+
+    void bytes(void *p, size_t n) {
+        if(loading) {
+            if(pos + n > data.size()) throw std::runtime_error("checkpoint is cut short");
+            memcpy(p, data.data() + pos, n);
+        }
+        else data.append((const char *)p, n);
+        pos += n;
+    }
+
+    template<typename T> void one(T &v) { one(v, std::is_trivially_copyable<T>()); }
+    template<typename T> void one(T &v, std::true_type) { bytes(&v, sizeof(T)); }
+    template<typename T> void one(T &v, std::false_type) { v.persist(*this); }
+
+    void one(std::string &s) {
+        uint64_t n = size(s.size());
+        if(loading) s.resize(n);
+        bytes(&s[0], n);
+    }
+
+    template<typename T> void one(std::vector<T> &v) {
+        uint64_t n = size(v.size());
+        if(loading) v.resize(n);
+        elements(v, std::is_trivially_copyable<T>());
+    }
+    template<typename T> void elements(std::vector<T> &v, std::true_type) { bytes(v.data(), v.size() * sizeof(T)); }
+    template<typename T> void elements(std::vector<T> &v, std::false_type) {
+        for(auto &x : v) one(x);
+    }
+
+    template<typename T> void one(std::set<T> &s) {
+        uint64_t n = size(s.size());
+        if(!loading) {
+            for(T x : s) one(x);
+            return;
+        }
+        s.clear();
+        for(uint64_t i = 0; i < n; i++) {
+            T x;
+            one(x);
+            s.insert(x);
+        }
+    }
+
+    template<typename K, typename V> void one(std::map<K, V> &m) {
+        uint64_t n = size(m.size());
+        if(!loading) {
+            for(auto &e : m) {
+                K k = e.first;
+                io(k, e.second);
+            }
+            return;
+        }
+        m.clear();
+        for(uint64_t i = 0; i < n; i++) {
+            K k;
+            one(k);
+            one(m[k]);
+        }
+    }
+
+private:
+    uint64_t size(uint64_t n) { //a count written ahead of a container's elements
+        one(n);
+        if(loading && n > data.size() - pos) throw std::runtime_error("checkpoint is cut short");
+        return n;
+    }
+};
+
+//"artckpt" and a format number, the size of the state and then the state deflated
+static const char checkpoint_magic[8] = {'a', 'r', 't', 'c', 'k', 'p', 't', '1'};
+
+inline bool writeCheckpoint(const std::string &path, const archive &a) {
+    uLongf size = compressBound(a.data.size());
+    std::string out(sizeof(checkpoint_magic) + 8 + size, '\0');
+    memcpy(&out[0], checkpoint_magic, sizeof(checkpoint_magic));
+    uint64_t raw = a.data.size();
+    memcpy(&out[sizeof(checkpoint_magic)], &raw, 8);
+    //the canvas is most of it, level 1 is a good deal smaller and doesn't hold the render up for long
+    if(compress2((Bytef *)&out[sizeof(checkpoint_magic) + 8], &size, (const Bytef *)a.data.data(), a.data.size(), 1) != Z_OK) return false;
+    out.resize(sizeof(checkpoint_magic) + 8 + size);
+    return writeFile(path, out);
+}
+
+//false when there's no checkpoint there or it isn't whole
+inline bool readCheckpoint(const std::string &path, archive &a) {
+    std::ifstream in(path, std::ios::binary);
+    if(!in) return false;
+    std::string file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if(file.size() < sizeof(checkpoint_magic) + 8 || memcmp(file.data(), checkpoint_magic, sizeof(checkpoint_magic)) != 0) return false;
+    uint64_t raw;
+    memcpy(&raw, &file[sizeof(checkpoint_magic)], 8);
+    a.data.assign(raw, '\0');
+    uLongf size = raw;
+    if(uncompress((Bytef *)&a.data[0], &size, (const Bytef *)&file[sizeof(checkpoint_magic) + 8], file.size() - sizeof(checkpoint_magic) - 8) != Z_OK || size != raw) return false;
+    a.pos = 0;
+    return true;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+//finished images are encoded here rather than through ofSaveImage, split into strips that are
+//compressed on every core (png.h, jpeg.h)
+//  jpg    what the sketches have always saved
+//  png    lossless, 8 bits a channel
+//  png16  lossless, 16 bits a channel, read straight from the float canvas so additive glow
+//         isn't rounded to 8 bits first
+//a sketch writes every format in its list next to each other, <seed>.jpg and <seed>.png,
+//ART_FORMATS=jpg,png16 sets the list, batch takes -f and the daemon format=
+//smaller copies go next to them in every format too, <seed>-1080.jpg with its longest side 1080,
+//averaged down from the pixels read back rather than the file (resize.h),
+//ART_SIZES=1080,540 sets them, batch takes -sizes and the daemon sizes=
+
+#include "ofMain.h"
+#include "pool.h"
+#include "png.h"
+#include "jpeg.h"
+#include "resize.h"
+#include <stdexcept>
+
+struct image_format {
+    std::string name, ext;
+    int depth; //bits a channel
+    int quality; //jpg only
+};
+
+inline image_format imageFormat(const std::string &name) {
+    if(name == "jpg") return {name, "jpg", 8, 100}; //ofSaveImage's best, which is what it used to be
+    if(name == "png") return {name, "png", 8, 0};
+    if(name == "png16") return {name, "png", 16, 0};
+    throw std::invalid_argument("unknown image format " + name);
+}
+
+//comma separated, throws on a name it doesn't know
+inline std::vector<image_format> imageFormats(const std::string &list) {
+    std::vector<image_format> formats;
+    std::stringstream in(list);
+    std::string name;
+    while(getline(in, name, ','))
+        if(!name.empty()) {
+            auto f = imageFormat(name);
+            for(auto &other : formats)
+                if(other.ext == f.ext) throw std::invalid_argument(other.name + " and " + name + " would both be ." + f.ext);
+            formats.push_back(f);
+        }
+    if(formats.empty()) throw std::invalid_argument("no image formats");
+    return formats;
+}
+
+inline std::string formatNames(const std::vector<image_format> &formats) {
+    std::string names;
+    for(auto &f : formats) names += (names.empty() ? "" : ",") + f.name;
+    return names;
+}
+
+inline const std::vector<image_format> &defaultFormats() {
+    static std::vector<image_format> formats = [] {
+        try {
+            if(getenv("ART_FORMATS")) return imageFormats(getenv("ART_FORMATS"));
+        } catch(std::invalid_argument &e) {
+            std::cerr << "ART_FORMATS: " << e.what() << ", saving jpg" << std::endl;
+        }
+        return imageFormats("jpg");
+    }();
+    return formats;
+}
+
+//comma separated longest sides, throws on one that isn't a whole number above 0
+inline std::vector<int> imageSizes(const std::string &list) {
+    std::vector<int> sizes;
+    std::stringstream in(list);
+    std::string size;
+    while(getline(in, size, ','))
+        if(!size.empty()) {
+            size_t end = 0;
+            int n = 0;
+            try {
+                n = stoi(size, &end);
+            } catch(std::exception &) {}
+            if(n <= 0 || end != size.size()) throw std::invalid_argument("bad image size " + size);
+            sizes.push_back(n);
+        }
+    return sizes;
+}
+
+inline std::string sizeNames(const std::vector<int> &sizes) {
+    std::string names;
+    for(int s : sizes) names += (names.empty() ? "" : ",") + std::to_string(s);
+    return names;
+}
+
+inline const std::vector<int> &defaultSizes() { //none unless ART_SIZES asks
+    static std::vector<int> sizes = [] {
+        try {
+            if(getenv("ART_SIZES")) return imageSizes(getenv("ART_SIZES"));
+        } catch(std::invalid_argument &e) {
+            std::cerr << "ART_SIZES: " << e.what() << ", saving the full size only" << std::endl;
+        }
+        return std::vector<int>();
+    }();
+    return sizes;
+}
+
+//where the copy with its longest side size goes, next to base.<ext>
+inline std::string sizedPath(const std::string &base, int size, const image_format &format) {
+    return base + "-" + std::to_string(size) + "." + format.ext;
+}
+
+//what's read back from a finished canvas, 16 bit pixels only when a format wants them
+struct image_pixels {
+    ofPixels pixels;
+    ofShortPixels deep;
+};
+
+inline thread_pool &encoderThreads() { //shared by every image being encoded
+    static thread_pool pool;
+    return pool;
+}
+
+inline bool saveImage(const image_pixels &pix, const image_format &format, const std::string &path) {
+    if(format.ext == "jpg") return saveJpeg(pix.pixels, path, encoderThreads(), format.quality);
+    if(format.depth == 16) return savePng(pix.deep, path, encoderThreads());
+    return savePng(pix.pixels, path, encoderThreads());
+}
+
+//pix made smaller, its longest side size
+inline image_pixels downscale(const image_pixels &pix, int size) {
+    image_pixels out;
+    if(pix.pixels.isAllocated()) out.pixels = downscale(pix.pixels, size);
+    if(pix.deep.isAllocated()) out.deep = downscale(pix.deep, size);
+    return out;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+//paper grain, a gaussian grey level for every pixel of a rectangle, blended on at alpha 60
+//it used to be drawn as millions of 1x1 rectangles before a sketch even started,
+//now the levels are made as one block and the canvas blends them in a single pass
+//finished grains are kept in memory, and on disk in ART_GRAIN_CACHE when that's set
+//ART_GRAIN_CLASSES=n makes every seed use one of n shared grains (seed % n) so a batch only
+//makes n of them, that changes the images so those renders are cached apart
+
+#include "ofMain.h"
+#include "rng.h"
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+struct grain {
+    static const int version = 1; //of how the levels are made, part of the file names on disk
+    int x, y, width, height; //the rectangle on the canvas
+    std::vector<unsigned char> levels; //row by row
+
+    //column x draws from r.stream("grain", x) as it always has, so seeds keep their grain
+    static std::shared_ptr<grain> make(rng &r, int x, int y, int w, int h) {
+        auto g = std::make_shared<grain>();
+        g->x = x, g->y = y, g->width = w, g->height = h;
+        g->levels.resize((size_t)w * h);
+        std::vector<double> shades(h);
+        for(int i = 0; i < w; i++) {
+            r.stream("grain", x + i).gaussians(shades.data(), h, 240, 30); //a column at a time
+            for(int j = 0; j < h; j++) {
+                int shade = shades[j];
+                g->levels[(size_t)j * w + i] = ofColor(shade, shade, shade, 60).r; //wraps the way setColor did
+            }
+        }
+        return g;
+    }
+};
+
+inline int grainClasses() { //0 when every seed has its own grain
+    static int n = getenv("ART_GRAIN_CLASSES") ? std::max(0, atoi(getenv("ART_GRAIN_CLASSES"))) : 0;
+    return n;
+}
+
+//the last few grains made, shared between every sketch rendering in the process
+struct grain_cache {
+    std::mutex lock;
+    std::list<std::pair<std::string, std::shared_ptr<const grain> > > recent; //most recently used first
+    size_t capacity = 8; //a 2000x2000 grain is 4MB
+    std::string dir = getenv("ART_GRAIN_CACHE") ? std::string(getenv("ART_GRAIN_CACHE")) + "/" : "";
+
+    static grain_cache &get() {
+        static grain_cache cache;
+        return cache;
+    }
+
+    //the grain for a seed over a rectangle, made if nobody has it
+    //two renders asking at once may both make it, they come out the same
+    std::shared_ptr<const grain> find(unsigned seed, int x, int y, int w, int h) {
+        int classes = grainClasses();
+        unsigned owner = (classes ? seed % classes : seed);
+        std::stringstream name;
+        name << "grain" << grain::version << "-" << std::hex << owner << std::dec << (classes ? "c" : "") << "-"
+             << x << "," << y << "," << w << "x" << h;
+        std::string key = name.str();
+
+        {
+            std::lock_guard<std::mutex> l(lock);
+            for(auto i = recent.begin(); i != recent.end(); i++)
+                if(i->first == key) {
+                    recent.splice(recent.begin(), recent, i);
+                    return i->second;
+                }
+        }
+
+        std::shared_ptr<grain> g;
+        if(!dir.empty()) g = load(dir + key, x, y, w, h);
+        if(!g) {
+            rng r;
+            r.exact = false;
+            r.seed(owner);
+            g = grain::make(r, x, y, w, h);
+            if(!dir.empty()) save(*g, dir + key);
+        }
+
+        std::lock_guard<std::mutex> l(lock);
+        recent.push_front({key, g});
+        if(recent.size() > capacity) recent.pop_back();
+        return g;
+    }
+
+    static std::shared_ptr<grain> load(const std::string &path, int x, int y, int w, int h) {
+        std::ifstream in(path, std::ios::binary);
+        if(!in) return nullptr;
+        auto g = std::make_shared<grain>();
+        g->x = x, g->y = y, g->width = w, g->height = h;
+        g->levels.resize((size_t)w * h);
+        in.read((char *)g->levels.data(), g->levels.size());
+        if(in.gcount() != (std::streamsize)g->levels.size() || in.peek() != EOF) return nullptr; //not one of ours
+        return g;
+    }
+
+    static void save(const grain &g, const std::string &path) { //renamed into place so nobody reads half of one
+        std::string tmp = path + "-" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream out(tmp, std::ios::binary);
+            out.write((const char *)g.levels.data(), g.levels.size());
+            if(!out) {
+                unlink(tmp.c_str());
+                return;
+            }
+        }
+        rename(tmp.c_str(), path.c_str());
+    }
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+//baseline jpeg written strip by strip on several threads
+//the restart interval is one strip of mcu rows, a restart resets the dc prediction,
+//so every strip is coded on its own and they're joined with RSTn markers in between
+//4:2:0 with the standard tables scaled by quality the way libjpeg does, like freeimage wrote them
+
+#include "ofMain.h"
+#include "pool.h"
+#include <cmath>
+#include <fstream>
+
+namespace jpeg {
+
+//natural index of every coefficient in zigzag order
+static const unsigned char zigzag[64] = {
+    0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+//annex k of the standard, in natural order
+static const unsigned char luma_quant[64] = {
+    16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+    14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+    18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+static const unsigned char chroma_quant[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+
+//huffman tables as they're stored in the file, codes of each length 1..16 then the symbols
+static const unsigned char dc_luma[] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const unsigned char dc_chroma[] = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const unsigned char ac_luma[] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa};
+static const unsigned char ac_chroma[] = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77,
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa};
+
+struct huffman {
+    unsigned short code[256] = {};
+    unsigned char size[256] = {};
+
+    huffman(const unsigned char *table) {
+        const unsigned char *symbol = table + 16;
+        unsigned short c = 0;
+        for(int length = 1; length <= 16; length++, c <<= 1)
+            for(int i = 0; i < table[length - 1]; i++, c++) {
+                code[*symbol] = c;
+                size[*symbol++] = length;
+            }
+    }
+};
+
+//entropy coded bytes, with a 0 stuffed after every 0xff
+struct bit_writer {
+    std::vector<unsigned char> out;
+    uint64_t bits = 0;
+    int count = 0; //bits waiting, under 32 between calls
+
+    void put(unsigned code, int size) {
+        bits = (bits << size) | code;
+        count += size;
+        if(count >= 32) {
+            count -= 32;
+            emit(bits >> count, 4);
+            bits &= (1ull << count) - 1;
+        }
+    }
+
+    void emit(uint32_t word, int bytes) { //the top bytes of word
+        for(int i = 3; i > 3 - bytes; i--) {
+            unsigned char b = word >> (8 * i);
+            out.push_back(b);
+            if(b == 0xff) out.push_back(0);
+        }
+    }
+
+    void flush() { //to a byte boundary with 1 bits, before a marker
+        if(count % 8) put((1u << (8 - count % 8)) - 1, 8 - count % 8);
+        if(count) emit(bits << (32 - count), count / 8);
+        bits = count = 0;
+    }
+};
+
+//libjpeg's quality scaling, clamped to what baseline allows
+inline void scaleQuant(const unsigned char *base, int quality, unsigned char *out) {
+    quality = std::min(100, std::max(1, quality));
+    int scale = (quality < 50 ? 5000 / quality : 200 - quality * 2);
+    for(int i = 0; i < 64; i++) out[i] = std::min(255, std::max(1, (base[i] * scale + 50) / 100));
+}
+
+//aan's factored dct, the one libjpeg's float dct uses, in place on 8 values step apart
+//comes out scaled by 8 * aan(u) * aan(v), which the quantizer divisors undo
+inline void dct8(float *d, int step) {
+    float t0 = d[0] + d[7 * step], t7 = d[0] - d[7 * step];
+    float t1 = d[step] + d[6 * step], t6 = d[step] - d[6 * step];
+    float t2 = d[2 * step] + d[5 * step], t5 = d[2 * step] - d[5 * step];
+    float t3 = d[3 * step] + d[4 * step], t4 = d[3 * step] - d[4 * step];
+
+    float t10 = t0 + t3, t13 = t0 - t3, t11 = t1 + t2, t12 = t1 - t2;
+    d[0] = t10 + t11;
+    d[4 * step] = t10 - t11;
+    float z1 = (t12 + t13) * 0.707106781f;
+    d[2 * step] = t13 + z1;
+    d[6 * step] = t13 - z1;
+
+    t10 = t4 + t5, t11 = t5 + t6, t12 = t6 + t7;
+    float z5 = (t10 - t12) * 0.382683433f;
+    float z2 = 0.541196100f * t10 + z5, z4 = 1.306562965f * t12 + z5, z3 = t11 * 0.707106781f;
+    float z11 = t7 + z3, z13 = t7 - z3;
+    d[5 * step] = z13 + z2;
+    d[3 * step] = z13 - z2;
+    d[step] = z11 + z4;
+    d[7 * step] = z11 - z4;
+}
+
+struct coder {
+    float luma_scale[64], chroma_scale[64]; //1 / (quantizer * the dct's own scale)
+    huffman dcl, acl, dcc, acc;
+
+    coder(const unsigned char *luma, const unsigned char *chroma) : dcl(dc_luma), acl(ac_luma), dcc(dc_chroma), acc(ac_chroma) {
+        double aan[8];
+        for(int k = 0; k < 8; k++) aan[k] = (k ? cos(k * M_PI / 16) * sqrt(2.0) : 1);
+        for(int i = 0; i < 64; i++) {
+            luma_scale[i] = 1 / (luma[i] * aan[i / 8] * aan[i % 8] * 8);
+            chroma_scale[i] = 1 / (chroma[i] * aan[i / 8] * aan[i % 8] * 8);
+        }
+    }
+
+    static int category(int v) {
+        return v ? 32 - __builtin_clz(abs(v)) : 0;
+    }
+
+    //one 8x8 block of level shifted samples, transformed in place
+    void block(float *f, const float *scale, int &dc, const huffman &dch, const huffman &ach, bit_writer &out) const {
+        for(int y = 0; y < 8; y++) dct8(f + y * 8, 1);
+        for(int x = 0; x < 8; x++) dct8(f + x, 8);
+
+        int q[64];
+        for(int i = 0; i < 64; i++) {
+            float v = f[i] * scale[i];
+            int limit = (i ? 1023 : 2047); //what baseline can code
+            q[i] = std::min(limit, std::max(-limit, (int)(v < 0 ? v - 0.5f : v + 0.5f)));
+        }
+
+        int diff = q[0] - dc;
+        dc = q[0];
+        int n = category(diff);
+        out.put(dch.code[n], dch.size[n]);
+        if(n) out.put((diff < 0 ? diff - 1 : diff) & ((1 << n) - 1), n);
+
+        int run = 0;
+        for(int k = 1; k < 64; k++) {
+            int v = q[zigzag[k]];
+            if(!v) {
+                run++;
+                continue;
+            }
+            for(; run >= 16; run -= 16) out.put(ach.code[0xf0], ach.size[0xf0]);
+            n = category(v);
+            out.put(ach.code[(run << 4) | n], ach.size[(run << 4) | n]);
+            out.put((v < 0 ? v - 1 : v) & ((1 << n) - 1), n);
+            run = 0;
+        }
+        if(run) out.put(ach.code[0], ach.size[0]);
+    }
+};
+
+inline void marker(std::vector<unsigned char> &out, int m, const std::vector<unsigned char> &body) {
+    out.insert(out.end(), {0xff, (unsigned char)m, (unsigned char)((body.size() + 2) >> 8), (unsigned char)(body.size() + 2)});
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+}
+
+inline bool saveJpeg(const ofPixels &pix, const std::string &path, thread_pool &pool, int quality = 100) {
+    int width = pix.getWidth(), height = pix.getHeight(), channels = pix.getNumChannels();
+    if(!pix.isAllocated() || width <= 0 || height <= 0 || width > 65535 || height > 65535 || channels < 3) return false;
+    int mcus_x = (width + 15) / 16, mcus_y = (height + 15) / 16;
+    int rows = std::max(1, std::min(8, 65535 / mcus_x)); //mcu rows per strip, the restart interval has to fit 16 bits
+    int strips = (mcus_y + rows - 1) / rows;
+
+    unsigned char luma[64], chroma[64];
+    jpeg::scaleQuant(jpeg::luma_quant, quality, luma);
+    jpeg::scaleQuant(jpeg::chroma_quant, quality, chroma);
+    jpeg::coder coder(luma, chroma);
+
+    std::vector<std::vector<unsigned char> > coded(strips);
+    parallelFor(pool, strips, [&](int k) {
+        jpeg::bit_writer out;
+        out.out.reserve((size_t)mcus_x * 16 * 16 * rows); //about what a strip takes at best quality
+        int dc[3] = {0, 0, 0};
+        float y[4][64], cb[64], cr[64];
+        for(int my = k * rows; my < std::min(mcus_y, (k + 1) * rows); my++)
+            for(int mx = 0; mx < mcus_x; mx++) {
+                std::fill(cb, cb + 64, 0.0f);
+                std::fill(cr, cr + 64, 0.0f);
+                for(int j = 0; j < 16; j++) {
+                    int py = std::min(height - 1, my * 16 + j); //past the edge repeats the last row and column
+                    const unsigned char *row = pix.getData() + (size_t)py * width * channels;
+                    for(int i = 0; i < 16; i++) {
+                        const unsigned char *p = row + std::min(width - 1, mx * 16 + i) * channels;
+                        float r = p[0], g = p[1], b = p[2];
+                        y[(j / 8) * 2 + i / 8][(j % 8) * 8 + i % 8] = 0.299f * r + 0.587f * g + 0.114f * b - 128;
+                        int c = (j / 2) * 8 + i / 2;
+                        cb[c] += 0.25f * (-0.168736f * r - 0.331264f * g + 0.5f * b);
+                        cr[c] += 0.25f * (0.5f * r - 0.418688f * g - 0.081312f * b);
+                    }
+                }
+                for(int b = 0; b < 4; b++) coder.block(y[b], coder.luma_scale, dc[0], coder.dcl, coder.acl, out);
+                coder.block(cb, coder.chroma_scale, dc[1], coder.dcc, coder.acc, out);
+                coder.block(cr, coder.chroma_scale, dc[2], coder.dcc, coder.acc, out);
+            }
+        out.flush();
+        coded[k] = std::move(out.out);
+    });
+
+    std::vector<unsigned char> head = {0xff, 0xd8};
+    jpeg::marker(head, 0xe0, {'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0});
+    std::vector<unsigned char> tables = {0};
+    for(int i = 0; i < 64; i++) tables.push_back(luma[jpeg::zigzag[i]]);
+    tables.push_back(1);
+    for(int i = 0; i < 64; i++) tables.push_back(chroma[jpeg::zigzag[i]]);
+    jpeg::marker(head, 0xdb, tables);
+    jpeg::marker(head, 0xc0, {8, (unsigned char)(height >> 8), (unsigned char)height, (unsigned char)(width >> 8), (unsigned char)width,
+        3, 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1});
+    std::vector<unsigned char> codes;
+    auto table = [&](int id, const unsigned char *t) {
+        int symbols = 0;
+        for(int i = 0; i < 16; i++) symbols += t[i];
+        codes.push_back(id);
+        codes.insert(codes.end(), t, t + 16 + symbols);
+    };
+    table(0x00, jpeg::dc_luma);
+    table(0x10, jpeg::ac_luma);
+    table(0x01, jpeg::dc_chroma);
+    table(0x11, jpeg::ac_chroma);
+    jpeg::marker(head, 0xc4, codes);
+    int interval = rows * mcus_x;
+    jpeg::marker(head, 0xdd, {(unsigned char)(interval >> 8), (unsigned char)interval});
+    jpeg::marker(head, 0xda, {3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0});
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char *)head.data(), head.size());
+    for(int k = 0; k < strips; k++) {
+        file.write((const char *)coded[k].data(), coded[k].size());
+        unsigned char end[] = {0xff, (unsigned char)(k + 1 < strips ? 0xd0 + k % 8 : 0xd9)}; //restart, or the end of the image
+        file.write((const char *)end, 2);
+    }
+    return (bool)file.flush();
+}
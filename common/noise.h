@@ -0,0 +1,396 @@
+#pragma once
+
+//ofNoise for many points at once
+//it's the same noise, stefan gustavson's simplex noise over ken perlin's permutation,
+//with the same float operations in the same order, so sketches that switch over look the same
+//the batch functions run 8 points at a time with avx2, 4 with sse2, or one by one on anything else,
+//every path goes through the same kernel so they all give the same numbers,
+//define NOISE_SCALAR to leave the simd out
+
+#include <cstdint>
+#include <algorithm>
+#if !defined(NOISE_SCALAR) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64))
+#define NOISE_SIMD
+#include <immintrin.h>
+#endif
+
+namespace noise {
+
+#define NOISE_PERMUTATION \
+    151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23, \
+    190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,88,237,149,56,87,174, \
+    20,125,136,171,168,68,175,74,165,71,134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133, \
+    230,220,105,92,41,55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,18, \
+    169,200,196,135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,250,124,123,5,202,38, \
+    147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,223,183,170,213,119,248,152, \
+    2,44,154,163,70,221,153,101,155,167,43,172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185, \
+    112,104,218,246,97,228,251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239, \
+    107,49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,138,236,205,93,222, \
+    114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
+
+//twice over so lookups never have to wrap, ints so avx2 can gather from it
+alignas(32) static const int perm[512] = {NOISE_PERMUTATION, NOISE_PERMUTATION};
+
+#undef NOISE_PERMUTATION
+
+//one lane, what the plain functions and the ends of batches use
+namespace lanes1 {
+    static const int width = 1;
+    struct vfloat { float v; vfloat() {} vfloat(float f) : v(f) {} };
+    struct vint { int v; vint() {} vint(int i) : v(i) {} };
+    struct vmask { bool v; };
+
+    inline vfloat operator+(vfloat a, vfloat b) { return a.v + b.v; }
+    inline vfloat operator-(vfloat a, vfloat b) { return a.v - b.v; }
+    inline vfloat operator*(vfloat a, vfloat b) { return a.v * b.v; }
+    inline vint operator+(vint a, vint b) { return a.v + b.v; }
+    inline vint operator&(vint a, int b) { return a.v & b; }
+    inline vmask operator>(vfloat a, vfloat b) { return {a.v > b.v}; }
+    inline vmask operator>=(vfloat a, vfloat b) { return {a.v >= b.v}; }
+    inline vmask operator<(vfloat a, vfloat b) { return {a.v < b.v}; }
+    inline vmask operator<(vint a, int b) { return {a.v < b}; }
+    inline vmask operator==(vint a, int b) { return {a.v == b}; }
+    inline vmask operator!(vmask a) { return {!a.v}; }
+    inline vmask operator&&(vmask a, vmask b) { return {a.v && b.v}; }
+    inline vmask operator||(vmask a, vmask b) { return {a.v || b.v}; }
+    inline vfloat select(vmask m, vfloat a, vfloat b) { return m.v ? a : b; }
+    inline vfloat flip(vmask m, vfloat a) { return m.v ? -a.v : a.v; }
+    inline vmask bit(vint a, int b) { return {(a.v & b) != 0}; }
+    inline vint one(vmask m) { return m.v ? 1 : 0; }
+    inline vint truncate(vfloat a) { return (int)a.v; }
+    inline vfloat tofloat(vint a) { return (float)a.v; }
+    inline vint lookup(vint i) { return perm[i.v]; }
+    inline vfloat load(vfloat, const float *p) { return *p; }
+    inline void store(float *p, vfloat a) { *p = a.v; }
+}
+
+#if defined(NOISE_SIMD)
+namespace lanes4 {
+    static const int width = 4;
+    struct vfloat { __m128 v; vfloat() {} vfloat(__m128 a) : v(a) {} vfloat(float f) : v(_mm_set1_ps(f)) {} };
+    struct vint { __m128i v; vint() {} vint(__m128i a) : v(a) {} vint(int i) : v(_mm_set1_epi32(i)) {} };
+    struct vmask { __m128 v; };
+
+    inline vfloat operator+(vfloat a, vfloat b) { return _mm_add_ps(a.v, b.v); }
+    inline vfloat operator-(vfloat a, vfloat b) { return _mm_sub_ps(a.v, b.v); }
+    inline vfloat operator*(vfloat a, vfloat b) { return _mm_mul_ps(a.v, b.v); }
+    inline vint operator+(vint a, vint b) { return _mm_add_epi32(a.v, b.v); }
+    inline vint operator&(vint a, int b) { return _mm_and_si128(a.v, _mm_set1_epi32(b)); }
+    inline vmask operator>(vfloat a, vfloat b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+    inline vmask operator>=(vfloat a, vfloat b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    inline vmask operator<(vfloat a, vfloat b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    inline vmask operator<(vint a, int b) { return {_mm_castsi128_ps(_mm_cmplt_epi32(a.v, _mm_set1_epi32(b)))}; }
+    inline vmask operator==(vint a, int b) { return {_mm_castsi128_ps(_mm_cmpeq_epi32(a.v, _mm_set1_epi32(b)))}; }
+    inline vmask operator!(vmask a) { return {_mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+    inline vmask operator&&(vmask a, vmask b) { return {_mm_and_ps(a.v, b.v)}; }
+    inline vmask operator||(vmask a, vmask b) { return {_mm_or_ps(a.v, b.v)}; }
+    inline vfloat select(vmask m, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+    inline vfloat flip(vmask m, vfloat a) { return _mm_xor_ps(a.v, _mm_and_ps(m.v, _mm_set1_ps(-0.0f))); }
+    inline vmask bit(vint a, int b) { return !((a & b) == 0); }
+    inline vint one(vmask m) { return _mm_and_si128(_mm_castps_si128(m.v), _mm_set1_epi32(1)); }
+    inline vint truncate(vfloat a) { return _mm_cvttps_epi32(a.v); }
+    inline vfloat tofloat(vint a) { return _mm_cvtepi32_ps(a.v); }
+    inline vint lookup(vint i) { //no gather before avx2
+        alignas(16) int in[4];
+        _mm_store_si128((__m128i *)in, i.v);
+        return _mm_setr_epi32(perm[in[0]], perm[in[1]], perm[in[2]], perm[in[3]]);
+    }
+    inline vfloat load(vfloat, const float *p) { return _mm_loadu_ps(p); }
+    inline void store(float *p, vfloat a) { _mm_storeu_ps(p, a.v); }
+}
+#endif
+
+#if defined(NOISE_SIMD) && defined(__AVX2__)
+namespace lanes8 {
+    static const int width = 8;
+    struct vfloat { __m256 v; vfloat() {} vfloat(__m256 a) : v(a) {} vfloat(float f) : v(_mm256_set1_ps(f)) {} };
+    struct vint { __m256i v; vint() {} vint(__m256i a) : v(a) {} vint(int i) : v(_mm256_set1_epi32(i)) {} };
+    struct vmask { __m256 v; };
+
+    inline vfloat operator+(vfloat a, vfloat b) { return _mm256_add_ps(a.v, b.v); }
+    inline vfloat operator-(vfloat a, vfloat b) { return _mm256_sub_ps(a.v, b.v); }
+    inline vfloat operator*(vfloat a, vfloat b) { return _mm256_mul_ps(a.v, b.v); }
+    inline vint operator+(vint a, vint b) { return _mm256_add_epi32(a.v, b.v); }
+    inline vint operator&(vint a, int b) { return _mm256_and_si256(a.v, _mm256_set1_epi32(b)); }
+    inline vmask operator>(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    inline vmask operator>=(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+    inline vmask operator<(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    inline vmask operator<(vint a, int b) { return {_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(b), a.v))}; }
+    inline vmask operator==(vint a, int b) { return {_mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, _mm256_set1_epi32(b)))}; }
+    inline vmask operator!(vmask a) { return {_mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+    inline vmask operator&&(vmask a, vmask b) { return {_mm256_and_ps(a.v, b.v)}; }
+    inline vmask operator||(vmask a, vmask b) { return {_mm256_or_ps(a.v, b.v)}; }
+    inline vfloat select(vmask m, vfloat a, vfloat b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+    inline vfloat flip(vmask m, vfloat a) { return _mm256_xor_ps(a.v, _mm256_and_ps(m.v, _mm256_set1_ps(-0.0f))); }
+    inline vmask bit(vint a, int b) { return !((a & b) == 0); }
+    inline vint one(vmask m) { return _mm256_and_si256(_mm256_castps_si256(m.v), _mm256_set1_epi32(1)); }
+    inline vint truncate(vfloat a) { return _mm256_cvttps_epi32(a.v); }
+    inline vfloat tofloat(vint a) { return _mm256_cvtepi32_ps(a.v); }
+    inline vint lookup(vint i) { return _mm256_i32gather_epi32(perm, i.v, 4); }
+    inline vfloat load(vfloat, const float *p) { return _mm256_loadu_ps(p); }
+    inline void store(float *p, vfloat a) { _mm256_storeu_ps(p, a.v); }
+}
+#endif
+
+//the kernels, written once for every width
+//they follow the reference code line by line, branches turned into selects
+namespace kernel {
+
+template<typename vint, typename vfloat>
+inline vint fastfloor(vfloat x) { //not quite floor, whole numbers go one down, but that's what ofNoise does
+    vint i = truncate(x);
+    return i + one(x > vfloat(0.0f)) + vint(-1);
+}
+
+template<typename vint, typename vfloat>
+inline vfloat grad2(vint hash, vfloat x, vfloat y) {
+    vint h = hash & 7;
+    vfloat u = select(h < 4, x, y);
+    vfloat v = select(h < 4, y, x);
+    return flip(bit(h, 1), u) + flip(bit(h, 2), vfloat(2.0f) * v);
+}
+
+template<typename vint, typename vfloat>
+inline vfloat grad3(vint hash, vfloat x, vfloat y, vfloat z) {
+    vint h = hash & 15;
+    vfloat u = select(h < 8, x, y);
+    vfloat v = select(h < 4, y, select(h == 12 || h == 14, x, z));
+    return flip(bit(h, 1), u) + flip(bit(h, 2), v);
+}
+
+template<typename vint, typename vfloat>
+inline vfloat grad4(vint hash, vfloat x, vfloat y, vfloat z, vfloat t) {
+    vint h = hash & 31;
+    vfloat u = select(h < 24, x, y);
+    vfloat v = select(h < 16, y, z);
+    vfloat w = select(h < 8, z, t);
+    return flip(bit(h, 1), u) + flip(bit(h, 2), v) + flip(bit(h, 4), w);
+}
+
+template<typename vfloat>
+inline vfloat falloff(vfloat t, vfloat g) { //t^4 * g where t > 0
+    vfloat tt = t * t;
+    return select(t < vfloat(0.0f), vfloat(0.0f), tt * tt * g);
+}
+
+template<typename vint, typename vfloat>
+vfloat simplex2(vfloat x, vfloat y) {
+    const float F2 = 0.366025403f, G2 = 0.211324865f;
+    vfloat s = (x + y) * F2;
+    vint i = fastfloor<vint>(x + s);
+    vint j = fastfloor<vint>(y + s);
+    vfloat t = tofloat(i + j) * G2;
+    vfloat x0 = x - (tofloat(i) - t);
+    vfloat y0 = y - (tofloat(j) - t);
+
+    auto upper = x0 > y0;
+    vint i1 = one(upper), j1 = one(!upper);
+
+    vfloat x1 = x0 - tofloat(i1) + G2;
+    vfloat y1 = y0 - tofloat(j1) + G2;
+    vfloat x2 = x0 - 1.0f + 2.0f * G2;
+    vfloat y2 = y0 - 1.0f + 2.0f * G2;
+
+    vint ii = i & 0xff, jj = j & 0xff;
+    vfloat n0 = falloff(vfloat(0.5f) - x0 * x0 - y0 * y0, grad2(lookup(ii + lookup(jj)), x0, y0));
+    vfloat n1 = falloff(vfloat(0.5f) - x1 * x1 - y1 * y1, grad2(lookup(ii + i1 + lookup(jj + j1)), x1, y1));
+    vfloat n2 = falloff(vfloat(0.5f) - x2 * x2 - y2 * y2, grad2(lookup(ii + 1 + lookup(jj + 1)), x2, y2));
+    return vfloat(40.0f) * (n0 + n1 + n2);
+}
+
+template<typename vint, typename vfloat>
+vfloat simplex3(vfloat x, vfloat y, vfloat z) {
+    const float F3 = 0.333333333f, G3 = 0.166666667f;
+    vfloat s = (x + y + z) * F3;
+    vint i = fastfloor<vint>(x + s);
+    vint j = fastfloor<vint>(y + s);
+    vint k = fastfloor<vint>(z + s);
+    vfloat t = tofloat(i + j + k) * G3;
+    vfloat x0 = x - (tofloat(i) - t);
+    vfloat y0 = y - (tofloat(j) - t);
+    vfloat z0 = z - (tofloat(k) - t);
+
+    //which of the six tetrahedra we're in, the reference's if/else tree as masks
+    auto xy = x0 >= y0, yz = y0 >= z0, xz = x0 >= z0;
+    vint i1 = one(xy && (yz || xz));
+    vint j1 = one(!xy && yz);
+    vint k1 = one(!yz && (!xz || !xy));
+    vint i2 = one(xy || (yz && xz));
+    vint j2 = one(!xy || yz);
+    vint k2 = one(!yz || (!xy && !xz));
+
+    vfloat x1 = x0 - tofloat(i1) + G3;
+    vfloat y1 = y0 - tofloat(j1) + G3;
+    vfloat z1 = z0 - tofloat(k1) + G3;
+    vfloat x2 = x0 - tofloat(i2) + 2.0f * G3;
+    vfloat y2 = y0 - tofloat(j2) + 2.0f * G3;
+    vfloat z2 = z0 - tofloat(k2) + 2.0f * G3;
+    vfloat x3 = x0 - 1.0f + 3.0f * G3;
+    vfloat y3 = y0 - 1.0f + 3.0f * G3;
+    vfloat z3 = z0 - 1.0f + 3.0f * G3;
+
+    vint ii = i & 0xff, jj = j & 0xff, kk = k & 0xff;
+    vfloat n0 = falloff(vfloat(0.6f) - x0 * x0 - y0 * y0 - z0 * z0,
+        grad3(lookup(ii + lookup(jj + lookup(kk))), x0, y0, z0));
+    vfloat n1 = falloff(vfloat(0.6f) - x1 * x1 - y1 * y1 - z1 * z1,
+        grad3(lookup(ii + i1 + lookup(jj + j1 + lookup(kk + k1))), x1, y1, z1));
+    vfloat n2 = falloff(vfloat(0.6f) - x2 * x2 - y2 * y2 - z2 * z2,
+        grad3(lookup(ii + i2 + lookup(jj + j2 + lookup(kk + k2))), x2, y2, z2));
+    vfloat n3 = falloff(vfloat(0.6f) - x3 * x3 - y3 * y3 - z3 * z3,
+        grad3(lookup(ii + 1 + lookup(jj + 1 + lookup(kk + 1))), x3, y3, z3));
+    return vfloat(32.0f) * (n0 + n1 + n2 + n3);
+}
+
+template<typename vint, typename vfloat>
+vfloat simplex4(vfloat x, vfloat y, vfloat z, vfloat w) {
+    const float F4 = 0.309016994f, G4 = 0.138196601f;
+    vfloat s = (x + y + z + w) * F4;
+    vint i = fastfloor<vint>(x + s);
+    vint j = fastfloor<vint>(y + s);
+    vint k = fastfloor<vint>(z + s);
+    vint l = fastfloor<vint>(w + s);
+    vfloat t = tofloat(i + j + k + l) * G4;
+    vfloat x0 = x - (tofloat(i) - t);
+    vfloat y0 = y - (tofloat(j) - t);
+    vfloat z0 = z - (tofloat(k) - t);
+    vfloat w0 = w - (tofloat(l) - t);
+
+    //the reference looks the order of the coordinates up in a table, counting how many
+    //each one beats gives the same ranks without a lookup
+    auto c1 = x0 > y0, c2 = x0 > z0, c3 = y0 > z0, c4 = x0 > w0, c5 = y0 > w0, c6 = z0 > w0;
+    vint rx = one(c1) + one(c2) + one(c4);
+    vint ry = one(!c1) + one(c3) + one(c5);
+    vint rz = one(!c2) + one(!c3) + one(c6);
+    vint rw = one(!c4) + one(!c5) + one(!c6);
+
+    vint i1 = one(!(rx < 3)), j1 = one(!(ry < 3)), k1 = one(!(rz < 3)), l1 = one(!(rw < 3));
+    vint i2 = one(!(rx < 2)), j2 = one(!(ry < 2)), k2 = one(!(rz < 2)), l2 = one(!(rw < 2));
+    vint i3 = one(!(rx < 1)), j3 = one(!(ry < 1)), k3 = one(!(rz < 1)), l3 = one(!(rw < 1));
+
+    vfloat x1 = x0 - tofloat(i1) + G4;
+    vfloat y1 = y0 - tofloat(j1) + G4;
+    vfloat z1 = z0 - tofloat(k1) + G4;
+    vfloat w1 = w0 - tofloat(l1) + G4;
+    vfloat x2 = x0 - tofloat(i2) + 2.0f * G4;
+    vfloat y2 = y0 - tofloat(j2) + 2.0f * G4;
+    vfloat z2 = z0 - tofloat(k2) + 2.0f * G4;
+    vfloat w2 = w0 - tofloat(l2) + 2.0f * G4;
+    vfloat x3 = x0 - tofloat(i3) + 3.0f * G4;
+    vfloat y3 = y0 - tofloat(j3) + 3.0f * G4;
+    vfloat z3 = z0 - tofloat(k3) + 3.0f * G4;
+    vfloat w3 = w0 - tofloat(l3) + 3.0f * G4;
+    vfloat x4 = x0 - 1.0f + 4.0f * G4;
+    vfloat y4 = y0 - 1.0f + 4.0f * G4;
+    vfloat z4 = z0 - 1.0f + 4.0f * G4;
+    vfloat w4 = w0 - 1.0f + 4.0f * G4;
+
+    vint ii = i & 0xff, jj = j & 0xff, kk = k & 0xff, ll = l & 0xff;
+    vfloat n0 = falloff(vfloat(0.6f) - x0 * x0 - y0 * y0 - z0 * z0 - w0 * w0,
+        grad4(lookup(ii + lookup(jj + lookup(kk + lookup(ll)))), x0, y0, z0, w0));
+    vfloat n1 = falloff(vfloat(0.6f) - x1 * x1 - y1 * y1 - z1 * z1 - w1 * w1,
+        grad4(lookup(ii + i1 + lookup(jj + j1 + lookup(kk + k1 + lookup(ll + l1)))), x1, y1, z1, w1));
+    vfloat n2 = falloff(vfloat(0.6f) - x2 * x2 - y2 * y2 - z2 * z2 - w2 * w2,
+        grad4(lookup(ii + i2 + lookup(jj + j2 + lookup(kk + k2 + lookup(ll + l2)))), x2, y2, z2, w2));
+    vfloat n3 = falloff(vfloat(0.6f) - x3 * x3 - y3 * y3 - z3 * z3 - w3 * w3,
+        grad4(lookup(ii + i3 + lookup(jj + j3 + lookup(kk + k3 + lookup(ll + l3)))), x3, y3, z3, w3));
+    vfloat n4 = falloff(vfloat(0.6f) - x4 * x4 - y4 * y4 - z4 * z4 - w4 * w4,
+        grad4(lookup(ii + 1 + lookup(jj + 1 + lookup(kk + 1 + lookup(ll + 1)))), x4, y4, z4, w4));
+    return vfloat(27.0f) * (n0 + n1 + n2 + n3 + n4);
+}
+
+//ofNoise maps the -1 to 1 of the reference onto 0 to 1
+template<typename vfloat>
+inline vfloat unit(vfloat n) {
+    return n * 0.5f + 0.5f;
+}
+
+//the batch loop, as many lanes at a time as there are, then one at a time for the rest
+//f gets a vfloat of the width it's running, load takes one too so it's found along with it
+template<typename F>
+void run(int n, F f) {
+    int i = 0;
+#if defined(NOISE_SIMD) && defined(__AVX2__)
+    for(; i + 8 <= n; i += 8) f(lanes8::vfloat(), i);
+#elif defined(NOISE_SIMD)
+    for(; i + 4 <= n; i += 4) f(lanes4::vfloat(), i);
+#endif
+    for(; i < n; i++) f(lanes1::vfloat(), i);
+}
+
+}
+
+//the same as ofNoise with the same arguments
+inline float noise(float x, float y) {
+    using namespace lanes1;
+    return kernel::unit(kernel::simplex2<vint>(vfloat(x), vfloat(y))).v;
+}
+
+inline float noise(float x, float y, float z) {
+    using namespace lanes1;
+    return kernel::unit(kernel::simplex3<vint>(vfloat(x), vfloat(y), vfloat(z))).v;
+}
+
+inline float noise(float x, float y, float z, float w) {
+    using namespace lanes1;
+    return kernel::unit(kernel::simplex4<vint>(vfloat(x), vfloat(y), vfloat(z), vfloat(w))).v;
+}
+
+//out[i] = noise(x[i], y[i], ...) for n points
+inline void noise(int n, const float *x, const float *y, float *out) {
+    kernel::run(n, [&](auto lanes, int i) {
+        typedef decltype(truncate(lanes)) vint;
+        store(out + i, kernel::unit(kernel::simplex2<vint>(load(lanes, x + i), load(lanes, y + i))));
+    });
+}
+
+inline void noise(int n, const float *x, const float *y, const float *z, float *out) {
+    kernel::run(n, [&](auto lanes, int i) {
+        typedef decltype(truncate(lanes)) vint;
+        store(out + i, kernel::unit(kernel::simplex3<vint>(load(lanes, x + i), load(lanes, y + i), load(lanes, z + i))));
+    });
+}
+
+inline void noise(int n, const float *x, const float *y, const float *z, const float *w, float *out) {
+    kernel::run(n, [&](auto lanes, int i) {
+        typedef decltype(truncate(lanes)) vint;
+        store(out + i, kernel::unit(kernel::simplex4<vint>(load(lanes, x + i), load(lanes, y + i), load(lanes, z + i), load(lanes, w + i))));
+    });
+}
+
+//octaves of noise added up, each at twice the frequency and half the weight of the one before
+//the last coordinate is usually a seed and stays where it is, sums are in double like the sketches did
+inline void fbm(int n, const float *x, const float *y, float z, int octaves, double *out) {
+    const int chunk = 256;
+    float xs[chunk], ys[chunk], zs[chunk], values[chunk];
+    std::fill(zs, zs + chunk, z);
+    for(int start = 0; start < n; start += chunk) {
+        int m = std::min(chunk, n - start);
+        std::fill(out + start, out + start + m, 0.0);
+        double weight = 1;
+        float scale = 1;
+        for(int o = 0; o < octaves; o++, weight /= 2, scale *= 2) {
+            for(int i = 0; i < m; i++) xs[i] = x[start+i] * scale, ys[i] = y[start+i] * scale;
+            noise(m, xs, ys, zs, values);
+            for(int i = 0; i < m; i++) out[start+i] += weight * values[i];
+        }
+    }
+}
+
+inline void fbm(int n, const float *x, const float *y, const float *z, float w, int octaves, double *out) {
+    const int chunk = 256;
+    float xs[chunk], ys[chunk], zs[chunk], ws[chunk], values[chunk];
+    std::fill(ws, ws + chunk, w);
+    for(int start = 0; start < n; start += chunk) {
+        int m = std::min(chunk, n - start);
+        std::fill(out + start, out + start + m, 0.0);
+        double weight = 1;
+        float scale = 1;
+        for(int o = 0; o < octaves; o++, weight /= 2, scale *= 2) {
+            for(int i = 0; i < m; i++) xs[i] = x[start+i] * scale, ys[i] = y[start+i] * scale, zs[i] = z[start+i] * scale;
+            noise(m, xs, ys, zs, ws, values);
+            for(int i = 0; i < m; i++) out[start+i] += weight * values[i];
+        }
+    }
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+//hsb colors at full brightness, what field and fujii color every point they splat with,
+//looked up in a table built once per render rather than worked out with setHsb each time
+//at full brightness a color is white less its saturation times how far the pure hue is from white,
+//so the table only has to go round the hues, with the corners of the hue circle (red, yellow, green...)
+//on entries, where the pure hues are straight lines between them
+//with a power of two entries to a sixth, interpolating between them is the same float arithmetic
+//setHsb does, so the colors come out exactly the same
+
+#include "ofMain.h"
+#include <vector>
+
+struct palette {
+    int steps; //entries to a sixth of the circle
+    std::vector<float> ink; //for every entry 1 minus the pure hue, r g b, then how much that changes to the next entry
+
+    palette(int _steps = 64) : steps(_steps) { //steps a power of two
+        int n = 6 * steps;
+        std::vector<float> pure; //the last one is red again
+        for(int i = 0; i <= n; i++) {
+            ofFloatColor c;
+            c.setHsb((float)(i % n) / n, 1, 1);
+            pure.insert(pure.end(), {1 - c.r, 1 - c.g, 1 - c.b});
+        }
+        for(int i = 0; i < n; i++) {
+            for(int k = 0; k < 3; k++) ink.push_back(pure[i*3+k]);
+            for(int k = 0; k < 3; k++) ink.push_back(pure[i*3+3+k] - pure[i*3+k]); //what the interpolation subtracts anyway
+        }
+    }
+
+    //setHsb(hue, sat, 1) with alpha 1, hues outside 0 to 1 go to setHsb
+    ofFloatColor operator()(float hue, float sat) const {
+        ofFloatColor c;
+        if(!(hue >= 0 && hue < 1)) {
+            c.setHsb(hue, sat, 1);
+            return c;
+        }
+        sat = std::min(std::max(sat, 0.0f), 1.0f);
+        float x = hue * 6 * steps; //hue*6 rounds like setHsb's, times steps doesn't round
+        int i = std::min((int)x, 6 * steps - 1); //hues just under 1 can round up to it
+        float f = x - i;
+        const float *a = &ink[i * 6];
+        c.r = 1 - sat * (a[0] + a[3] * f);
+        c.g = 1 - sat * (a[1] + a[4] * f);
+        c.b = 1 - sat * (a[2] + a[5] * f);
+        c.a = 1;
+        return c;
+    }
+
+    //out[i] = (*this)(hue[i], sat[i]) for n colors
+    void lookup(int n, const double *hue, const double *sat, ofFloatColor *out) const {
+        for(int i = 0; i < n; i++) out[i] = (*this)(hue[i], sat[i]);
+    }
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+//png written strip by strip on several threads
+//rows are filtered the way libpng does it (the filter with the smallest sum per row), then every
+//strip is deflated on its own, primed with the last 32k of the strip before it so it compresses
+//about as well as one long stream, and flushed to a byte boundary so the strips can simply be
+//written one after the other as IDAT chunks
+//8 or 16 bits a channel, rgb, the alpha of an fbo readback is dropped
+
+#include "ofMain.h"
+#include "pool.h"
+#include <atomic>
+#include <zlib.h>
+#include <fstream>
+
+namespace png {
+
+inline void put32(std::vector<unsigned char> &out, uint32_t v) {
+    for(int s = 24; s >= 0; s -= 8) out.push_back(v >> s);
+}
+
+inline void chunk(std::ostream &out, const char *type, const unsigned char *data, size_t size, uint32_t crc) {
+    std::vector<unsigned char> head;
+    put32(head, size);
+    head.insert(head.end(), type, type + 4);
+    out.write((const char *)head.data(), head.size());
+    out.write((const char *)data, size);
+    std::vector<unsigned char> tail;
+    put32(tail, crc);
+    out.write((const char *)tail.data(), tail.size());
+}
+
+inline uint32_t crc(const char *type, const unsigned char *data, size_t size) {
+    uLong c = crc32(0, (const Bytef *)type, 4);
+    return crc32(c, data, size);
+}
+
+//one row of big endian samples, what the filters work on
+template<typename T>
+void samples(const T *p, size_t width, int channels, unsigned char *row) {
+    for(size_t x = 0; x < width; x++, p += channels)
+        for(int c = 0; c < 3; c++)
+            for(int b = sizeof(T) - 1; b >= 0; b--) *row++ = p[c] >> (8 * b);
+}
+
+template<typename T>
+void samples(const ofPixels_<T> &pix, int y, unsigned char *row) {
+    samples(pix.getData() + (size_t)y * pix.getWidth() * pix.getNumChannels(), pix.getWidth(), pix.getNumChannels(), row);
+}
+
+inline void header(std::ostream &file, int width, int height, int depth) { //signature and IHDR
+    const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file.write((const char *)signature, sizeof(signature));
+    std::vector<unsigned char> ihdr;
+    put32(ihdr, width);
+    put32(ihdr, height);
+    ihdr.insert(ihdr.end(), {(unsigned char)depth, 2, 0, 0, 0}); //depth, rgb, deflate, no filter set, not interlaced
+    chunk(file, "IHDR", ihdr.data(), ihdr.size(), crc("IHDR", ihdr.data(), ihdr.size()));
+}
+
+inline int paeth(int a, int b, int c) {
+    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+//row filtered into out[0] (the filter type) and out[1..size], prev is zeros above the first row
+inline void filter(const unsigned char *row, const unsigned char *prev, size_t size, int bpp, unsigned char *out, std::vector<unsigned char> &scratch) {
+    scratch.resize(5 * size);
+    long best = -1;
+    int pick = 0;
+    for(int f = 0; f < 5; f++) {
+        unsigned char *o = scratch.data() + f * size;
+        long sum = 0;
+        for(size_t i = 0; i < size; i++) {
+            int a = (i >= (size_t)bpp ? row[i - bpp] : 0), b = prev[i], c = (i >= (size_t)bpp ? prev[i - bpp] : 0);
+            int predicted = (f == 0 ? 0 : f == 1 ? a : f == 2 ? b : f == 3 ? (a + b) / 2 : paeth(a, b, c));
+            o[i] = row[i] - predicted;
+            sum += abs((signed char)o[i]);
+        }
+        if(best < 0 || sum < best) best = sum, pick = f;
+    }
+    out[0] = pick;
+    memcpy(out + 1, scratch.data() + pick * size, size);
+}
+
+}
+
+template<typename T>
+bool savePng(const ofPixels_<T> &pix, const std::string &path, thread_pool &pool, int level = 6) {
+    int width = pix.getWidth(), height = pix.getHeight();
+    if(!pix.isAllocated() || width <= 0 || height <= 0 || pix.getNumChannels() < 3) return false;
+    int bpp = 3 * sizeof(T);
+    size_t row_size = (size_t)width * bpp, line = row_size + 1; //a filter type byte in front of every row
+    int rows = std::max<size_t>(1, (256 << 10) / line); //per strip
+    int strips = (height + rows - 1) / rows;
+
+    std::vector<unsigned char> filtered(line * height);
+    parallelFor(pool, strips, [&](int k) {
+        std::vector<unsigned char> row(row_size), prev(row_size, 0), scratch;
+        int y0 = k * rows, y1 = std::min(height, y0 + rows);
+        if(y0 > 0) png::samples(pix, y0 - 1, prev.data());
+        for(int y = y0; y < y1; y++) {
+            png::samples(pix, y, row.data());
+            png::filter(row.data(), prev.data(), row_size, bpp, filtered.data() + line * y, scratch);
+            row.swap(prev);
+        }
+    });
+
+    struct strip {
+        std::vector<unsigned char> data;
+        uLong adler;
+        size_t size;
+        uint32_t crc;
+    };
+    std::vector<strip> out(strips);
+    std::atomic<bool> ok(true); //strips fail on their own threads
+    parallelFor(pool, strips, [&](int k) {
+        size_t start = line * k * rows, size = line * (std::min(height, (k + 1) * rows) - k * rows);
+        z_stream z = {};
+        if(deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_FILTERED) != Z_OK) { //raw, the zlib header and adler are added around the strips
+            ok = false;
+            return;
+        }
+        if(k > 0) {
+            size_t window = std::min<size_t>(32768, start);
+            deflateSetDictionary(&z, filtered.data() + start - window, window);
+        }
+        auto &s = out[k];
+        if(k == 0) s.data = {0x78, 0x9c};
+        size_t head = s.data.size();
+        s.data.resize(head + deflateBound(&z, size) + 16);
+        z.next_in = filtered.data() + start;
+        z.avail_in = size;
+        z.next_out = s.data.data() + head;
+        z.avail_out = s.data.size() - head;
+        int flush = (k + 1 == strips ? Z_FINISH : Z_SYNC_FLUSH); //the last strip ends the stream
+        int r = deflate(&z, flush);
+        if(!(flush == Z_FINISH ? r == Z_STREAM_END : r == Z_OK && z.avail_in == 0)) ok = false;
+        s.data.resize(head + z.total_out);
+        deflateEnd(&z);
+        s.adler = adler32(1, filtered.data() + start, size);
+        s.size = size;
+        s.crc = png::crc("IDAT", s.data.data(), s.data.size());
+    });
+    if(!ok) return false;
+
+    uLong adler = out[0].adler;
+    for(int k = 1; k < strips; k++) adler = adler32_combine(adler, out[k].adler, out[k].size);
+    std::vector<unsigned char> trailer;
+    png::put32(trailer, adler);
+    auto &last = out.back();
+    last.data.insert(last.data.end(), trailer.begin(), trailer.end());
+    last.crc = crc32(last.crc, trailer.data(), trailer.size()); //crc32 carries on from where it was
+
+    std::ofstream file(path, std::ios::binary);
+    png::header(file, width, height, 8 * sizeof(T));
+    for(auto &s : out) png::chunk(file, "IDAT", s.data.data(), s.data.size(), s.crc);
+    png::chunk(file, "IEND", nullptr, 0, png::crc("IEND", nullptr, 0));
+    return (bool)file.flush();
+}
+
+//a png written a row at a time on one thread, for images too big to hold in memory, see tiles.h
+template<typename T>
+struct png_stream {
+    std::ofstream file;
+    z_stream z = {};
+    int width = 0, height = 0, rows = 0;
+    std::vector<unsigned char> row, prev, line, scratch, out;
+    bool ok = false;
+
+    png_stream(const std::string &path, int _width, int _height, int level = 6) :
+        file(path, std::ios::binary), width(_width), height(_height) {
+        size_t size = (size_t)width * 3 * sizeof(T);
+        row.resize(size);
+        prev.assign(size, 0);
+        line.resize(size + 1);
+        out.resize(1 << 20); //each IDAT
+        ok = file && width > 0 && height > 0 && deflateInit2(&z, level, Z_DEFLATED, 15, 8, Z_FILTERED) == Z_OK;
+        if(!ok) return;
+        png::header(file, width, height, 8 * sizeof(T));
+        z.next_out = out.data();
+        z.avail_out = out.size();
+    }
+
+    ~png_stream() {
+        deflateEnd(&z);
+    }
+
+    bool add(const T *rgb) { //the next row, width rgb samples
+        if(!ok || rows >= height) return ok = false;
+        png::samples(rgb, width, 3, row.data());
+        png::filter(row.data(), prev.data(), row.size(), 3 * sizeof(T), line.data(), scratch);
+        row.swap(prev);
+        z.next_in = line.data();
+        z.avail_in = line.size();
+        rows++;
+        return pump(rows == height ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    bool close() { //false unless every row went in and reached the file
+        if(!ok || rows != height) return false;
+        png::chunk(file, "IEND", nullptr, 0, png::crc("IEND", nullptr, 0));
+        return (bool)file.flush();
+    }
+
+private:
+    bool pump(int flush) {
+        while(true) {
+            if(z.avail_out == 0) emit();
+            int r = deflate(&z, flush);
+            if(r == Z_STREAM_ERROR) return ok = false;
+            if(flush == Z_FINISH ? r == Z_STREAM_END : z.avail_in == 0 && z.avail_out > 0) break;
+        }
+        if(flush == Z_FINISH) emit();
+        return ok = ok && file;
+    }
+
+    void emit() {
+        size_t n = out.size() - z.avail_out;
+        if(n) png::chunk(file, "IDAT", out.data(), n, png::crc("IDAT", out.data(), n));
+        z.next_out = out.data();
+        z.avail_out = out.size();
+    }
+};
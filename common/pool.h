@@ -0,0 +1,95 @@
+#pragma once
+
+//fixed set of worker threads pulling jobs off a queue
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+struct thread_pool {
+    thread_pool(int threads = 0) {
+        if(threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for(int i = 0; i < threads; i++)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto &w : workers) w.join();
+    }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            jobs.push_back(std::move(job));
+            pending++;
+        }
+        wake.notify_one();
+    }
+
+    void wait() { //until every submitted job has finished
+        std::unique_lock<std::mutex> guard(lock);
+        idle.wait(guard, [this] { return pending == 0; });
+    }
+
+    int size() const {
+        return workers.size();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()> > jobs;
+    std::mutex lock;
+    std::condition_variable wake, idle;
+    int pending = 0;
+    bool stopping = false;
+
+    void work() {
+        while(true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+                if(jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+            std::lock_guard<std::mutex> guard(lock);
+            if(--pending == 0) idle.notify_all();
+        }
+    }
+};
+
+//f(0) .. f(n-1) on the calling thread and the pool's together, returns once every one has run
+//the caller mustn't be one of the pool's own threads
+inline void parallelFor(thread_pool &pool, int n, const std::function<void(int)> &f) {
+    struct progress {
+        std::atomic<int> next{0};
+        int done = 0;
+        std::mutex lock;
+        std::condition_variable finished;
+    };
+    auto p = std::make_shared<progress>();
+    auto run = [p, n, &f] { //helpers that start late find nothing left and never touch f
+        for(int i; (i = p->next++) < n; ) {
+            f(i);
+            std::lock_guard<std::mutex> guard(p->lock);
+            if(++p->done == n) p->finished.notify_all();
+        }
+    };
+    for(int i = 1; i < std::min(n, pool.size() + 1); i++) pool.submit(run);
+    run();
+    std::unique_lock<std::mutex> guard(p->lock);
+    p->finished.wait(guard, [&] { return p->done == n; });
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+//jobs shared between machines through a directory, every state change is a rename
+//so two nodes can never both own a job
+//  queue/<job>          waiting to be claimed
+//  claimed/<job>@<node> being rendered, the node touches it every so often
+//  done/<job>           finished
+//  failed/<job>         gave up, the reason is appended to the file
+//  images/              output of every node
+//a claim that hasn't been touched for timeout seconds is put back in the queue
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+struct work_queue {
+    std::string dir;
+    std::string node;
+    int timeout = 300; //seconds without a heartbeat before a claim is considered dead
+
+    work_queue(const std::string &_dir, int _timeout = 300) : dir(_dir), timeout(_timeout) {
+        char host[256] = "";
+        gethostname(host, sizeof(host)-1);
+        node = std::string(host) + "-" + std::to_string(getpid());
+        for(auto d : {"", "/queue", "/claimed", "/done", "/failed", "/images", "/tmp"})
+            mkdir((dir + d).c_str(), 0777);
+    }
+
+    //write the file somewhere private first so the queue never sees half a job
+    bool push(const std::string &job, const std::string &contents) {
+        std::string tmp = dir + "/tmp/" + job + "@" + node;
+        {
+            std::ofstream out(tmp);
+            out << contents << "\n";
+            if(!out) return false;
+        }
+        return rename(tmp.c_str(), (dir + "/queue/" + job).c_str()) == 0;
+    }
+
+    //takes the first job nobody else got to, empty if the queue is empty
+    std::string claim() {
+        for(auto &job : list("/queue"))
+            if(rename((dir + "/queue/" + job).c_str(), claimed(job).c_str()) == 0) {
+                heartbeat(job); //a rename keeps the old time, which could already look stale
+                return job;
+            }
+        return "";
+    }
+
+    std::string read(const std::string &job) {
+        std::ifstream in(claimed(job));
+        std::string contents;
+        getline(in, contents);
+        return contents;
+    }
+
+    bool heartbeat(const std::string &job) { //false if the claim was taken away from us
+        return utimes(claimed(job).c_str(), nullptr) == 0;
+    }
+
+    bool finish(const std::string &job) {
+        return rename(claimed(job).c_str(), (dir + "/done/" + job).c_str()) == 0;
+    }
+
+    bool fail(const std::string &job, const std::string &reason) {
+        std::string path = dir + "/failed/" + job;
+        if(rename(claimed(job).c_str(), path.c_str()) != 0) return false;
+        std::ofstream(path, std::ios::app) << node << ": " << reason << "\n";
+        return true;
+    }
+
+    //put claims from nodes that stopped heartbeating back in the queue
+    int requeueStale() {
+        int count = 0;
+        for(auto &name : list("/claimed")) {
+            struct stat st;
+            std::string path = dir + "/claimed/" + name;
+            if(stat(path.c_str(), &st) != 0 || time(nullptr) - st.st_mtime < timeout) continue;
+            std::string job = name.substr(0, name.rfind('@'));
+            if(rename(path.c_str(), (dir + "/queue/" + job).c_str()) == 0) count++;
+        }
+        return count;
+    }
+
+    bool idle() { //nothing waiting and nothing being worked on
+        return list("/queue").empty() && list("/claimed").empty();
+    }
+
+    std::vector<std::string> list(const std::string &state) {
+        std::vector<std::string> names;
+        if(DIR *d = opendir((dir + state).c_str())) {
+            while(dirent *e = readdir(d))
+                if(e->d_name[0] != '.') names.push_back(e->d_name);
+            closedir(d);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+private:
+    std::string claimed(const std::string &job) {
+        return dir + "/claimed/" + job + "@" + node;
+    }
+};
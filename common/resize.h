@@ -0,0 +1,159 @@
+#pragma once
+
+//images made smaller for the sizes written next to the full one (encoder.h) and contact sheets
+//every new pixel is the average of the area of the old image it covers, old pixels cut by its edges
+//counting for the part inside, which is what a downscale that doesn't alias or blur wants
+//rows go in one at a time and come out as soon as they're finished, so neither image has to be held
+//pixels are 4 floats in between, summed 4 at a time with sse2, define RESIZE_SCALAR to leave it out
+
+#include "ofMain.h"
+#include <functional>
+#include <limits>
+#include <vector>
+#if !defined(RESIZE_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define RESIZE_SIMD
+#include <immintrin.h>
+#endif
+
+namespace resize {
+
+//out += w * in over n floats
+inline void addScaled(float *out, const float *in, float w, int n) {
+    int i = 0;
+#if defined(RESIZE_SIMD)
+    __m128 vw = _mm_set1_ps(w);
+    for(; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(vw, _mm_loadu_ps(in + i))));
+#endif
+    for(; i < n; i++) out[i] += w * in[i];
+}
+
+//a row of pixels, 4 floats each, averaged across into fewer, with what each new pixel takes of each old one
+struct across {
+    int taps = 1;
+    std::vector<int> first; //old pixel each new one starts at
+    std::vector<float> weights; //taps for every new pixel, 0 past the ones it covers
+
+    across() {}
+    across(int in, int out) {
+        //old pixel j spans [j*out, (j+1)*out), new pixel i [i*in, (i+1)*in), in whole units so the edges are exact
+        for(int i = 0; i < out; i++) taps = std::max(taps, (int)(((long long)(i + 1) * in - 1) / out - (long long)i * in / out + 1));
+        first.resize(out);
+        weights.assign((size_t)out * taps, 0);
+        for(int i = 0; i < out; i++) {
+            long long lo = (long long)i * in, hi = lo + in;
+            first[i] = std::min<long long>(lo / out, in - taps);
+            for(int t = 0; t < taps; t++) {
+                long long j = first[i] + t;
+                long long overlap = std::min(hi, (j + 1) * out) - std::max(lo, j * out);
+                if(overlap > 0) weights[(size_t)i * taps + t] = (double)overlap / in;
+            }
+        }
+    }
+
+    void apply(const float *in, float *out) const {
+        for(int i = 0; i < (int)first.size(); i++) {
+            const float *p = in + (size_t)first[i] * 4;
+            const float *w = &weights[(size_t)i * taps];
+#if defined(RESIZE_SIMD)
+            __m128 sum = _mm_setzero_ps();
+            for(int t = 0; t < taps; t++) sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(p + t * 4)));
+            _mm_storeu_ps(out + (size_t)i * 4, sum);
+#else
+            float sum[4] = {0, 0, 0, 0};
+            for(int t = 0; t < taps; t++)
+                for(int k = 0; k < 4; k++) sum[k] += w[t] * p[t * 4 + k];
+            for(int k = 0; k < 4; k++) out[(size_t)i * 4 + k] = sum[k];
+#endif
+        }
+    }
+};
+
+}
+
+//in_w x in_h rows of channels samples of T in, out_w x out_h rows out through finished,
+//which gets each as soon as the last old row it covers has gone in, no bigger than the old size
+template<typename T>
+struct downscaler {
+    int in_w, in_h, out_w, out_h, channels;
+    std::function<void(const T *)> finished;
+    resize::across columns;
+    std::vector<float> wide, narrow, sum; //an old row, it averaged across, the new row so far
+    std::vector<T> row;
+    int y = 0, out_y = 0;
+
+    downscaler(int _in_w, int _in_h, int _out_w, int _out_h, int _channels, std::function<void(const T *)> _finished) :
+        in_w(_in_w), in_h(_in_h), out_w(std::min(_out_w, _in_w)), out_h(std::min(_out_h, _in_h)), channels(_channels),
+        finished(_finished), columns(in_w, out_w) {
+        wide.assign((size_t)in_w * 4, 0);
+        narrow.resize((size_t)out_w * 4);
+        sum.assign((size_t)out_w * 4, 0);
+        row.resize((size_t)out_w * channels);
+    }
+
+    void add(const T *in) { //the next old row
+        if(y >= in_h) return;
+        if(channels >= 3) { //the 4th of rgb stays 0
+            const T *p = in;
+            for(int x = 0; x < in_w; x++, p += channels) {
+                float *w = &wide[(size_t)x * 4];
+                w[0] = p[0], w[1] = p[1], w[2] = p[2];
+                if(channels >= 4) w[3] = p[3];
+            }
+        }
+        else
+            for(int x = 0; x < in_w; x++)
+                for(int k = 0; k < channels; k++) wide[(size_t)x * 4 + k] = in[(size_t)x * channels + k];
+        columns.apply(wide.data(), narrow.data());
+
+        //old row y spans [y*out_h, (y+1)*out_h), new row out_y ends at (out_y+1)*in_h
+        long long lo = (long long)y * out_h, hi = lo + out_h, end = (long long)(out_y + 1) * in_h;
+        int n = out_w * 4;
+        if(hi <= end) resize::addScaled(sum.data(), narrow.data(), (float)((double)out_h / in_h), n);
+        else resize::addScaled(sum.data(), narrow.data(), (float)((double)(end - lo) / in_h), n);
+        if(hi >= end) {
+            emit();
+            std::fill(sum.begin(), sum.end(), 0);
+            if(hi > end) resize::addScaled(sum.data(), narrow.data(), (float)((double)(hi - end) / in_h), n);
+        }
+        y++;
+    }
+
+private:
+    void emit() {
+        float top = std::numeric_limits<T>::max();
+        int n = std::min(channels, 4);
+        T *q = row.data();
+        for(int x = 0; x < out_w; x++, q += channels)
+            for(int k = 0; k < n; k++) q[k] = (T)std::min(top, std::max(0.0f, sum[(size_t)x * 4 + k] + 0.5f));
+        finished(row.data());
+        out_y++;
+    }
+};
+
+//the size an image of w x h comes out at with its longest side longest, never bigger
+inline void fitSize(int w, int h, int longest, int &out_w, int &out_h) {
+    if(std::max(w, h) <= longest) {
+        out_w = w, out_h = h;
+        return;
+    }
+    out_w = std::max(1, (int)((long long)w * longest / std::max(w, h)));
+    out_h = std::max(1, (int)((long long)h * longest / std::max(w, h)));
+    if(w >= h) out_w = longest;
+    else out_h = longest;
+}
+
+//a whole image at once, with its longest side longest
+template<typename T>
+ofPixels_<T> downscale(const ofPixels_<T> &in, int longest) {
+    int w, h, c = in.getNumChannels();
+    fitSize(in.getWidth(), in.getHeight(), longest, w, h);
+    ofPixels_<T> out;
+    out.allocate(w, h, c);
+    T *q = out.getData();
+    downscaler<T> d(in.getWidth(), in.getHeight(), w, h, c, [&](const T *row) {
+        std::copy(row, row + (size_t)w * c, q);
+        q += (size_t)w * c;
+    });
+    for(size_t y = 0; y < in.getHeight(); y++) d.add(in.getData() + y * in.getWidth() * c);
+    return out;
+}
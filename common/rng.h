@@ -0,0 +1,175 @@
+#pragma once
+
+//randomness owned by a single sketch, stands in for the global ofRandom
+//so several seeds can render side by side without sharing state
+//
+//numbers come from philox, a counter based generator: the nth number of a stream is
+//a hash of the seed and n, so a sketch can hand every fractal, particle or walker its
+//own stream with stream(purpose, index) and they come out the same whatever order or
+//thread they're drawn in
+
+#include <random>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+//layers for the ziggurat method of drawing normal samples, marsaglia and tsang's
+//with the tables laid out as in doornik's zignor
+struct ziggurat {
+    static constexpr int layers = 128;
+    static constexpr double r = 3.442619855899; //where the tail starts
+    static constexpr double v = 9.91256303526217e-3; //area of each layer
+
+    double x[layers+1]; //right edge of each layer
+    double ratio[layers]; //how much of each layer lies under the one above, those samples need no test
+
+    ziggurat() {
+        double f = exp(-0.5 * r * r);
+        x[0] = v / f; //the bottom layer includes the tail, as if it were a rectangle
+        x[1] = r;
+        x[layers] = 0;
+        for(int i = 2; i < layers; i++) {
+            x[i] = sqrt(-2 * log(v / x[i-1] + f));
+            f = exp(-0.5 * x[i] * x[i]);
+        }
+        for(int i = 0; i < layers; i++)
+            ratio[i] = x[i+1] / x[i];
+    }
+
+    static const ziggurat &get() {
+        static const ziggurat z;
+        return z;
+    }
+};
+
+//philox4x32-10 from salmon et al, "parallel random numbers: as easy as 1, 2, 3"
+//ten rounds of multiplies and xors turn a 128 bit counter and 64 bit key into 128 random bits
+inline void philox(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for(int i = 0; i < 10; i++) {
+        uint64_t p0 = (uint64_t)0xD2511F53 * c0, p1 = (uint64_t)0xCD9E8D57 * c2;
+        uint32_t hi0 = p0 >> 32, lo0 = p0, hi1 = p1 >> 32, lo1 = p1;
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+struct rng {
+    uint32_t key[2] = {0, 0}; //the seed
+    uint32_t counter[4] = {0, 0, 0, 0}; //block number (two words), index, purpose
+    uint32_t block[4];
+    int used = 4; //numbers of block already handed out
+
+    //draw from one std::mt19937 with gaussians from std::normal_distribution like version 1
+    //of every sketch did, so old seeds come out exactly as they were (on the same standard library)
+    //every stream then shares the one sequence, so it only works drawn in the original order
+    bool exact = getenv("ART_EXACT") != nullptr;
+    std::shared_ptr<std::mt19937> engine;
+
+    void seed(unsigned s) {
+        key[0] = s;
+        counter[0] = counter[1] = counter[2] = counter[3] = 0;
+        used = 4;
+        engine = (exact ? std::make_shared<std::mt19937>(s) : nullptr);
+    }
+
+    //an independent stream for one of many things, like ("walker", id)
+    //the purpose is hashed so different kinds of things never share numbers
+    rng stream(const char *purpose, uint32_t index) {
+        if(exact) sequence();
+        rng r = *this;
+        uint32_t hash = 2166136261u; //32 bit fnv-1a
+        for(const char *c = purpose; *c; c++) {
+            hash ^= (unsigned char)*c;
+            hash *= 16777619u;
+        }
+        r.counter[0] = r.counter[1] = 0;
+        r.counter[2] = index;
+        r.counter[3] = hash | 1; //the seed's own stream has purpose 0
+        r.used = 4;
+        return r;
+    }
+
+    std::mt19937 &sequence() {
+        if(!engine) engine = std::make_shared<std::mt19937>(key[0]);
+        return *engine;
+    }
+
+    uint32_t next() {
+        if(exact) return sequence()();
+        if(used == 4) {
+            philox(counter, key, block);
+            if(++counter[0] == 0) counter[1]++;
+            used = 0;
+        }
+        return block[used++];
+    }
+
+    double uniform() { //[0, 1), spelled out so it's the same on every standard library
+        return next() / 4294967296.0;
+    }
+
+    double random(double max) {
+        return uniform() * max;
+    }
+
+    double random(double min, double max) {
+        return min + uniform() * (max - min);
+    }
+
+    //standard normal sample, about 99% of them cost two draws, a multiply and a compare
+    double normal() {
+        auto &z = ziggurat::get();
+        while(true) {
+            double u = 2 * uniform() - 1;
+            int i = next() & (ziggurat::layers - 1);
+            if(fabs(u) < z.ratio[i]) return u * z.x[i];
+            if(i == 0) return tail(u < 0);
+            double x = u * z.x[i]; //in the wedge between this layer and the curve
+            double f0 = exp(-0.5 * (z.x[i] * z.x[i] - x * x));
+            double f1 = exp(-0.5 * (z.x[i+1] * z.x[i+1] - x * x));
+            if(f1 + uniform() * (f0 - f1) < 1) return x;
+        }
+    }
+
+    double tail(bool negative) { //beyond ziggurat::r
+        double x, y;
+        do {
+            x = log(1 - uniform()) / ziggurat::r;
+            y = log(1 - uniform());
+        } while(-2 * y < x * x);
+        return negative ? x - ziggurat::r : ziggurat::r - x;
+    }
+
+    double gaussian(double mean, double deviation) {
+        if(exact) {
+            std::normal_distribution<double> nd(mean, deviation);
+            return nd(sequence());
+        }
+        return mean + deviation * normal();
+    }
+
+    //n samples into out, the same ones n calls to gaussian would give
+    void gaussians(double *out, int n, double mean, double deviation) {
+        if(exact) {
+            for(int i = 0; i < n; i++) out[i] = gaussian(mean, deviation);
+            return;
+        }
+        for(int i = 0; i < n; i++) out[i] = mean + deviation * normal();
+    }
+
+    //where the stream is up to, for checkpoints (see checkpoint.h), not in exact mode where streams share the engine
+    template<typename A> void persist(A &a) {
+        a.io(key, counter, block, used);
+    }
+};
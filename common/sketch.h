@@ -0,0 +1,248 @@
+#pragma once
+
+//a sketch packaged as a generator, one object renders one seed
+//it owns its parameters, canvas and randomness so many can run at once
+
+#include "ofMain.h"
+#include "canvas.h"
+#include "rng.h"
+#include "trace.h"
+#include "stats.h"
+#include "grain.h"
+#include "writer.h"
+#include "encoder.h"
+#include "checkpoint.h"
+#include "border.h"
+
+template<typename T>
+std::string join(const T &v) { //comma separated, for manifests
+    std::stringstream out;
+    for(auto i = std::begin(v); i != std::end(v); i++)
+        out << (i == std::begin(v) ? "" : ",") << *i;
+    return out.str();
+}
+
+struct sketch {
+    const std::string name;
+    const int width, height;
+    const int version; //bump when a change alters what old seeds look like
+
+    int seed = 0;
+    std::string seedstring;
+    std::unique_ptr<canvas> buffer;
+    rng rnd;
+    trace tracer;
+    render_stats stats;
+
+    long long budget = 0; //units of work before a budgeted sketch is done, set in setup
+    long long spent = 0;
+    int grain_class = -1; //which of the shared grains the paper came from, with ART_GRAIN_CLASSES
+    std::vector<image_format> formats = defaultFormats(); //what save writes, see encoder.h
+    std::vector<int> sizes = defaultSizes(); //and the longest sides of the smaller copies next to it
+    std::string checkpoint_path; //render writes a checkpoint here every checkpoint_every seconds
+    double checkpoint_every = 0;
+    //the inner math of field's flames, fujii's attractor and watercolor's deformation in float,
+    //with ART_FLOAT, regress compares it against the double renders
+    bool single = getenv("ART_FLOAT") != nullptr;
+    border margins; //where points are let through, see border.h
+
+    sketch(const std::string &_name, int _width, int _height, int _version = 1) :
+        name(_name), width(_width), height(_height), version(_version), margins(_width, _height) {}
+    virtual ~sketch() {}
+    virtual void setup() = 0; //randomise parameters and draw anything that is drawn up front
+    virtual void update() = 0; //one frame of work
+    virtual bool done() = 0;
+    virtual void describe(std::ostream &out) {} //the randomised parameters, one key=value per line
+    virtual void persist(archive &a) {} //whatever update moves on, for checkpoints
+
+    void start(int _seed, std::unique_ptr<canvas> c, long long _budget = 0) { //a nonzero budget replaces the sketch's own
+        seed = _seed;
+        rnd.seed(seed);
+        std::stringstream sstream;
+        sstream << std::hex << seed;
+        seedstring = sstream.str();
+        buffer = std::move(c);
+        tracer = trace(); //timed from this thread
+        stats = render_stats();
+        {
+            trace_scope t(tracer, "setup");
+            setup();
+        }
+        if(_budget) budget = _budget;
+    }
+
+    void step() { //update, timed as one frame
+        trace_scope t(tracer, "frame");
+        update();
+    }
+
+    void render() {
+        double last = trace::now();
+        while(!done()) {
+            step();
+            if(checkpoint_every > 0 && !checkpoint_path.empty() && !done() && trace::now() - last >= checkpoint_every * 1e6) {
+                checkpoint(checkpoint_path);
+                last = trace::now();
+            }
+        }
+    }
+
+    //the render so far, between frames, to be picked up by restore after this process is gone
+    //not in exact mode, where every stream shares one engine, or on an fbo
+    bool checkpoint(const std::string &path) {
+        if(rnd.exact) return false;
+        trace_scope t(tracer, "checkpoint");
+        archive a(false);
+        stats.counts["checkpoints"]++;
+        return persistAll(a) && writeCheckpoint(path, a);
+    }
+
+    //carry on from a checkpoint of this render, called after start with the same seed and budget,
+    //which sets up the parameters again, false and nothing changed when path isn't one
+    //a checkpoint from a build that persists differently can fail partway through loading,
+    //so the state start left is kept to go back to
+    bool restore(const std::string &path) {
+        if(rnd.exact) return false;
+        archive a(true);
+        if(!readCheckpoint(path, a)) return false;
+        archive before(false);
+        persistAll(before);
+        bool loaded;
+        try {
+            loaded = persistAll(a);
+        } catch(std::exception &e) {
+            std::cerr << "can't resume from " << path << ": " << e.what() << std::endl;
+            loaded = false;
+        }
+        if(!loaded) {
+            archive back(true);
+            back.data = std::move(before.data);
+            persistAll(back);
+            return false;
+        }
+        stats.counts["resumed"]++;
+        return true;
+    }
+
+    //base is the path without an extension, every format goes next to it with its own,
+    //<base>.stats too, and <base>.trace.json when tracing
+    bool save(const std::string &base) {
+        return write(readback(), base);
+    }
+
+    //save in two halves, readback needs the canvas (and the gl thread for an fbo),
+    //write only needs the pixels so it can run on a writer thread while the canvas is reused
+    image_pixels readback() {
+        trace_scope t(tracer, "readback");
+        image_pixels pix;
+        for(auto &f : formats) {
+            if(f.depth == 8 && !pix.pixels.isAllocated()) buffer->readToPixels(pix.pixels);
+            if(f.depth == 16 && !pix.deep.isAllocated()) buffer->readToPixels(pix.deep);
+        }
+        return pix;
+    }
+
+    bool deep() const { //wants 16 bits a channel, for makeCanvas
+        for(auto &f : formats)
+            if(f.depth == 16) return true;
+        return false;
+    }
+
+    //every file is written under a temporary name and renamed, see writer.h
+    bool write(const image_pixels &pix, const std::string &base) {
+        bool saved = true;
+        auto encode = [&](const image_pixels &p, const std::string &path, const image_format &f) {
+            std::string tmp = temporaryPath(path);
+            if(!saveImage(p, f, tmp) || !commitFile(tmp, path)) {
+                unlink(tmp.c_str());
+                saved = false;
+            }
+        };
+        {
+            trace_scope t(tracer, "encode");
+            for(auto &f : formats) encode(pix, base + "." + f.ext, f);
+        }
+        for(int size : sizes) {
+            image_pixels small;
+            {
+                trace_scope t(tracer, "downscale");
+                small = downscale(pix, size);
+            }
+            trace_scope t(tracer, "encode");
+            for(auto &f : formats) encode(small, sizedPath(base, size, f), f);
+        }
+        if(tracer.enabled) {
+            std::string tmp = temporaryPath(base + ".trace.json");
+            if(tracer.save(tmp)) commitFile(tmp, base + ".trace.json");
+        }
+        std::stringstream out;
+        out << "sketch=" << name << "\n";
+        out << "version=" << version << "\n";
+        out << "seed=" << seedstring << "\n";
+        out << "width=" << width << "\n";
+        out << "height=" << height << "\n";
+        out << "budget=" << budget << "\n";
+        out << "formats=" << formatNames(formats) << "\n";
+        if(!sizes.empty()) out << "sizes=" << sizeNames(sizes) << "\n";
+        stats.write(out, tracer, spent);
+        return writeFile(base + ".stats", out.str()) && saved;
+    }
+
+    //paper grain over a rectangle, from the grain cache unless gaussians are exact,
+    //then it has to come out of the one sequence in order
+    void drawGrain(int x, int y, int w, int h) {
+        trace_scope t(tracer, "grain");
+        auto g = (rnd.exact ? grain::make(rnd, x, y, w, h) : grain_cache::get().find(seed, x, y, w, h));
+        if(!rnd.exact && grainClasses()) grain_class = (unsigned)seed % grainClasses();
+        buffer->drawShades(g->levels.data(), x, y, w, h, 60);
+    }
+
+    typeface &loadFont(const std::string &file, int size, const std::vector<ofUnicode::range> &ranges = {}) {
+        trace_scope t(tracer, "font");
+        return loadTypeface(file, size, ranges);
+    }
+
+    std::string manifest() { //everything that went into this image
+        std::stringstream out;
+        out << "sketch=" << name << "\n";
+        out << "version=" << version << "\n";
+        out << "seed=" << seedstring << "\n";
+        out << "width=" << width << "\n";
+        out << "height=" << height << "\n";
+        out << "budget=" << budget << "\n";
+        if(rnd.exact) out << "gaussians=exact\n";
+        if(single) out << "precision=float\n";
+        if(grain_class >= 0) out << "grain_class=" << grain_class << "/" << grainClasses() << "\n";
+        describe(out);
+        return out.str();
+    }
+
+    //the render's state after setup, read or written, headed by what identifies the render
+    bool persistAll(archive &a) {
+        int format = 1;
+        std::string n = name;
+        int v = version, s = seed, w = width, h = height;
+        long long b = budget;
+        a.io(format, n, v, s, w, h, b);
+        if(a.loading && (format != 1 || n != name || v != version || s != seed || w != width || h != height || b != budget))
+            return false;
+        if(!buffer->persist(a)) return false;
+        a.io(spent, rnd, grain_class, stats.points, stats.rejected, stats.counts, tracer.phases);
+        persist(a);
+        return true;
+    }
+
+    double random(double max) { return rnd.random(max); }
+    double random(double min, double max) { return rnd.random(min, max); }
+    double gaussian(double mean, double deviation) { return rnd.gaussian(mean, deviation); }
+
+    ofVec2f getOffset(typeface &font, const std::string &s) {
+        ofRectangle r = font.getStringBoundingBox(s, 0, 0);
+        return ofVec2f( floor(-r.x - r.width * 0.5f), floor(-r.y - r.height * 0.5f) );
+    }
+
+    void drawStringCentered(typeface &font, const std::string &s, double x, double y) {
+        ofVec2f offset = getOffset(font, s);
+        buffer->drawString(font, s, x + offset.x, y + offset.y);
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+//every sketch by name, for tools that render more than one kind
+
+#include "../cell/src/cell.h"
+#include "../field/src/field.h"
+#include "../flow/src/flow.h"
+#include "../fujii/src/fujii.h"
+#include "../hexgrid/src/hexgrid.h"
+#include "../walker/src/walker.h"
+#include "../watercolor/src/watercolor.h"
+
+inline std::vector<std::string> sketchNames() {
+    return {"cell", "field", "flow", "fujii", "hexgrid", "walker", "watercolor"};
+}
+
+inline std::unique_ptr<sketch> makeSketch(const std::string &name) { //null if there's no such sketch
+    if(name == "cell") return std::make_unique<cell_sketch>();
+    if(name == "field") return std::make_unique<field_sketch>();
+    if(name == "flow") return std::make_unique<flow_sketch>();
+    if(name == "fujii") return std::make_unique<fujii_sketch>();
+    if(name == "hexgrid") return std::make_unique<hexgrid_sketch>();
+    if(name == "walker") return std::make_unique<walker_sketch>();
+    if(name == "watercolor") return std::make_unique<watercolor_sketch>();
+    return nullptr;
+}
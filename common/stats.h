@@ -0,0 +1,42 @@
+#pragma once
+
+//what a render did and how long it took, saved next to the image as <seed>.stats
+//one key=value per line like the manifests, times in milliseconds
+//the stats tool reads these back to compare builds
+
+#include "trace.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <sys/resource.h>
+
+struct render_stats {
+    long long points = 0; //splatted onto the canvas
+    long long rejected = 0; //thrown away by the rough border test
+    std::map<std::string, long long> counts; //sketch specific, like walkers spawned or nan resets
+
+    static long long peakRss() { //kilobytes, for the whole process so renders running together share it
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    void write(std::ostream &out, const trace &t, long long iterations) const {
+        out << "iterations=" << iterations << "\n";
+        out << "points=" << points << "\n";
+        out << "rejected=" << rejected << "\n";
+        for(auto &c : counts)
+            out << c.first << "=" << c.second << "\n";
+
+        double render = 0; //setup and frames, everything but saving
+        for(auto &p : t.phases) {
+            out << "wall." << p.first << "=" << p.second.wall / 1000 << "\n";
+            out << "cpu." << p.first << "=" << p.second.cpu / 1000 << "\n";
+            out << "count." << p.first << "=" << p.second.count << "\n";
+            if(p.first == "setup" || p.first == "frame") render += p.second.wall;
+        }
+        if(render > 0 && iterations) out << "iterations_per_second=" << iterations / render * 1e6 << "\n";
+        if(render > 0 && points) out << "points_per_second=" << points / render * 1e6 << "\n";
+        out << "peak_rss_kb=" << peakRss() << "\n";
+    }
+};
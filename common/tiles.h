@@ -0,0 +1,179 @@
+#pragma once
+
+//prints, a whole number of times the size a sketch is drawn at, rendered a tile at a time
+//every tile runs the whole sketch again from its seed, which draws the same thing every time,
+//and keeps only what lands on it, so memory goes with the size of a tile rather than the print
+//tiles are sparse canvases (canvas.h), so one only holds the parts of it the sketch draws on
+//finished tiles wait on disk as raw rows and are then stitched into one png, a row at a time,
+//or when the print is one tile its rows go straight into the png
+//points are unit squares like the fbo draws them, so a print looks like the screen render
+//with lines, shapes and text drawn at the full resolution
+
+#include "sketch.h"
+
+struct tile_canvas : cpu_canvas {
+    int factor; //print pixels per sketch pixel
+    int left, top, tile_width, tile_height; //where the tile is in the print
+
+    tile_canvas(int _factor, int _left, int _top, int w, int h) :
+        factor(_factor), left(_left), top(_top), tile_width(w), tile_height(h) {
+        sparse = true;
+    }
+
+    void allocate(int w, int h) { //w and h are the sketch's, only the tile is kept
+        cpu_canvas::allocate(tile_width, tile_height);
+        m.a = m.d = factor;
+        m.tx = -left;
+        m.ty = -top;
+    }
+
+    void drawPoint(double x, double y) {
+        if(factor == 1) cpu_canvas::drawPoint(x, y);
+        else drawRectangle(x, y, 1, 1);
+    }
+
+    //only the shades whose points can land on the tile
+    void drawShades(const unsigned char *shades, int x, int y, int w, int h, int alpha) {
+        if(m.b != 0 || m.c != 0 || m.a <= 0 || m.d <= 0 || w <= 0 || h <= 0) {
+            canvas::drawShades(shades, x, y, w, h, alpha);
+            return;
+        }
+        int i0 = std::max(0, (int)floor(-m.tx / m.a) - x - 1), i1 = std::min(w, (int)ceil((width - m.tx) / m.a) - x + 1);
+        int j0 = std::max(0, (int)floor(-m.ty / m.d) - y - 1), j1 = std::min(h, (int)ceil((height - m.ty) / m.d) - y + 1);
+        for(int j = j0; j < j1; j++)
+            for(int i = i0; i < i1; i++) {
+                int shade = shades[(size_t)j * w + i];
+                setColor(ofColor(shade, shade, shade, alpha));
+                drawPoint(x + i, y + j);
+            }
+        int last = shades[(size_t)w * h - 1];
+        setColor(ofColor(last, last, last, alpha));
+    }
+
+    //from the font loaded factor times bigger, rather than its small glyphs blown up
+    void drawString(typeface &font, const std::string &s, double x, double y) {
+        if(factor == 1) {
+            cpu_canvas::drawString(font, s, x, y);
+            return;
+        }
+        typeface &big = loadTypeface(font.file, font.size * factor, font.ranges);
+        pushMatrix();
+        translate(x, y);
+        scale(1.0 / factor, 1.0 / factor);
+        cpu_canvas::drawString(big, s, 0, 0);
+        popMatrix();
+    }
+};
+
+namespace tiles {
+
+struct tile {
+    int left, top, width, height;
+    std::string raw; //its rows on disk
+};
+
+template<typename T>
+std::string spill(cpu_canvas &c, const std::string &near) {
+    std::string path = temporaryPath(near);
+    std::ofstream out(path, std::ios::binary);
+    std::vector<T> row((size_t)c.width * 3);
+    for(int y = 0; y < c.height && out; y++) {
+        c.readRow(y, row.data());
+        out.write((const char *)row.data(), row.size() * sizeof(T));
+    }
+    if(out.flush()) return path;
+    unlink(path.c_str());
+    return "";
+}
+
+template<typename T>
+bool stream(cpu_canvas &c, const std::string &path) {
+    png_stream<T> png(path, c.width, c.height);
+    std::vector<T> row((size_t)c.width * 3);
+    for(int y = 0; y < c.height; y++) {
+        c.readRow(y, row.data());
+        if(!png.add(row.data())) return false;
+    }
+    return png.close();
+}
+
+//a row of tiles at a time, a row of pixels from each
+template<typename T>
+bool stitch(const std::vector<tile> &tiles, int across, int width, int height, const std::string &path) {
+    png_stream<T> png(path, width, height);
+    std::vector<T> row((size_t)width * 3);
+    for(size_t r = 0; r < tiles.size(); r += across) {
+        std::vector<std::ifstream> in;
+        for(int c = 0; c < across; c++)
+            in.emplace_back(tiles[r + c].raw, std::ios::binary);
+        for(int y = 0; y < tiles[r].height; y++) {
+            for(int c = 0; c < across; c++) {
+                auto &t = tiles[r + c];
+                if(!in[c].read((char *)(row.data() + (size_t)t.left * 3), (size_t)t.width * 3 * sizeof(T))) return false;
+            }
+            if(!png.add(row.data())) return false;
+        }
+    }
+    return png.close();
+}
+
+}
+
+//a print of seed at factor times the sketch's size, tiles of up to tile print pixels a side
+//render on the pool, then base.png is written for the png or png16 in formats, with the manifest
+//in base.txt, jpg isn't written a row at a time so it's left out
+inline bool renderTiles(const std::function<std::unique_ptr<sketch>()> &make, int seed, int factor, int tile,
+                        const std::vector<image_format> &formats, const std::string &base, thread_pool &pool) {
+    auto probe = make();
+    int width = probe->width * factor, height = probe->height * factor;
+    int across = (width + tile - 1) / tile, down = (height + tile - 1) / tile;
+    std::vector<tiles::tile> parts;
+    for(int j = 0; j < down; j++)
+        for(int i = 0; i < across; i++)
+            parts.push_back({i * tile, j * tile, std::min(tile, width - i * tile), std::min(tile, height - j * tile)});
+
+    const image_format *png = nullptr;
+    for(auto &f : formats)
+        if(f.ext == "png") png = &f;
+    if(!png) return false;
+
+    std::atomic<bool> ok(true);
+    std::string manifest, path = base + ".png", tmp = temporaryPath(path);
+    std::vector<double> occupied(parts.size());
+    for(size_t k = 0; k < parts.size(); k++)
+        pool.submit([&, k] {
+            auto &t = parts[k];
+            auto s = make();
+            s->formats = {*png};
+            s->start(seed, std::make_unique<tile_canvas>(factor, t.left, t.top, t.width, t.height));
+            if(k == 0) manifest = s->manifest();
+            s->render();
+            auto &c = static_cast<tile_canvas &>(*s->buffer);
+            occupied[k] = c.occupied();
+            if(parts.size() == 1) {
+                if(!(png->depth == 16 ? tiles::stream<unsigned short>(c, tmp) : tiles::stream<unsigned char>(c, tmp))) ok = false;
+                return;
+            }
+            t.raw = (png->depth == 16 ? tiles::spill<unsigned short>(c, base + ".tile") : tiles::spill<unsigned char>(c, base + ".tile"));
+            if(t.raw.empty()) ok = false;
+        });
+    pool.wait();
+
+    if(ok && parts.size() > 1)
+        ok = (png->depth == 16 ? tiles::stitch<unsigned short>(parts, across, width, height, tmp) :
+                                 tiles::stitch<unsigned char>(parts, across, width, height, tmp));
+    if(ok) ok = commitFile(tmp, path);
+    else unlink(tmp.c_str());
+    for(auto &t : parts)
+        if(!t.raw.empty()) unlink(t.raw.c_str());
+
+    std::stringstream out;
+    out << manifest;
+    out << "factor=" << factor << "\n";
+    out << "print=" << width << "x" << height << "\n";
+    out << "tiles=" << parts.size() << "\n";
+    double sum = 0;
+    for(double o : occupied) sum += o;
+    out << "occupied=" << sum / parts.size() << "\n"; //of each tile on average, how much memory the sparse canvas needed
+    return ok && writeFile(base + ".txt", out.str());
+}
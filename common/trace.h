@@ -0,0 +1,109 @@
+#pragma once
+
+//timeline of where a render spends its time, written as chrome trace event json
+//open it in chrome://tracing or https://ui.perfetto.dev
+//the events are only kept when ART_TRACE is set in the environment, but scopes always add
+//their wall and cpu time to per-phase totals for the stats sidecar, they're coarse enough
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct trace {
+    struct event {
+        const char *name;
+        double start, duration; //microseconds
+        long long count; //how many timed pieces went into it, 1 for plain scopes
+    };
+
+    struct phase {
+        double wall = 0, cpu = 0; //microseconds
+        long long count = 0;
+    };
+
+    bool enabled = getenv("ART_TRACE") != nullptr;
+    std::vector<event> events;
+    std::map<std::string, phase> phases;
+    int tid = std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000;
+
+    static double now() {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static double cpu() { //time this thread has spent running
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    }
+
+    void add(const char *name, double start, double duration, long long count = 1) {
+        events.push_back({name, start, duration, count});
+    }
+
+    bool save(const std::string &path) {
+        std::ofstream out(path);
+        out.precision(15);
+        out << "{\"traceEvents\": [\n";
+        for(size_t i = 0; i < events.size(); i++) {
+            auto &e = events[i];
+            out << "  {\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid
+                << ", \"ts\": " << e.start << ", \"dur\": " << e.duration
+                << ", \"args\": {\"count\": " << e.count << "}}" << (i+1 < events.size() ? ",\n" : "\n");
+        }
+        out << "], \"displayTimeUnit\": \"ms\"}\n";
+        return (bool)out;
+    }
+};
+
+//times everything until the end of the enclosing block
+struct trace_scope {
+    trace &t;
+    const char *name;
+    double start, cpu;
+
+    trace_scope(trace &_t, const char *_name) : t(_t), name(_name) {
+        start = trace::now();
+        cpu = trace::cpu();
+    }
+
+    ~trace_scope() {
+        double wall = trace::now() - start;
+        auto &p = t.phases[name];
+        p.wall += wall;
+        p.cpu += trace::cpu() - cpu;
+        p.count++;
+        if(t.enabled) t.add(name, start, wall);
+    }
+};
+
+//adds up many small pieces of work interleaved with other work, like splatting points
+//between simulation steps, and records them as one event where it started
+//too fine grained to time when tracing is off, so it's not in the phase totals
+struct trace_total {
+    trace &t;
+    const char *name;
+    double first = 0, piece = 0, total = 0;
+    long long count = 0;
+
+    trace_total(trace &_t, const char *_name) : t(_t), name(_name) {
+        if(t.enabled) first = trace::now();
+    }
+
+    void begin() {
+        if(t.enabled) piece = trace::now();
+    }
+
+    void end() {
+        if(t.enabled) total += trace::now() - piece, count++;
+    }
+
+    ~trace_total() {
+        if(t.enabled && count) t.add(name, first, total, count);
+    }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+//font that can be stamped onto a cpu canvas without a gl context
+//glyphs are rasterized with freetype (same library ofTrueTypeFont uses) and cached,
+//the opengl path gets a regular ofTrueTypeFont loaded lazily with the same settings
+//glyph lookups are locked, so one typeface can be shared by sketches on several threads
+
+#include "ofMain.h"
+#include <mutex>
+#include <tuple>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+struct typeface {
+    struct glyph {
+        int width = 0, height = 0, left = 0, top = 0;
+        double advance = 0;
+        std::vector<unsigned char> bitmap; //8 bit coverage, width*height
+    };
+
+    std::string file;
+    int size = 0;
+    std::vector<ofUnicode::range> ranges;
+
+    typeface() {}
+    typeface(const typeface &) = delete;
+    typeface &operator=(const typeface &) = delete;
+    ~typeface() {
+        if(face) FT_Done_Face(face);
+        if(library) FT_Done_FreeType(library);
+    }
+
+    void addRange(const ofUnicode::range &r) {
+        ranges.push_back(r);
+    }
+
+    bool load(std::string _file, int _size) {
+        file = _file;
+        size = _size;
+        glyphs.clear();
+        gl_loaded = false;
+        if(face) FT_Done_Face(face), face = nullptr;
+        if(!library && FT_Init_FreeType(&library)) return false;
+        if(FT_New_Face(library, ofToDataPath(file).c_str(), 0, &face)) {
+            face = nullptr;
+            return false;
+        }
+        //ofTrueTypeFont sizes fonts in points at 96 dpi
+        FT_Set_Char_Size(face, size << 6, size << 6, 96, 96);
+        return true;
+    }
+
+    const glyph &getGlyph(unsigned code) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = glyphs.find(code);
+        if(it != glyphs.end()) return it->second;
+        glyph &g = glyphs[code];
+        if(!face || FT_Load_Char(face, code, FT_LOAD_RENDER)) return g;
+        FT_GlyphSlot slot = face->glyph;
+        g.width = slot->bitmap.width;
+        g.height = slot->bitmap.rows;
+        g.left = slot->bitmap_left;
+        g.top = slot->bitmap_top;
+        g.advance = slot->advance.x / 64.0;
+        g.bitmap.resize(g.width * g.height);
+        for(int y = 0; y < g.height; y++)
+            memcpy(&g.bitmap[y * g.width], slot->bitmap.buffer + y * slot->bitmap.pitch, g.width);
+        return g;
+    }
+
+    //same convention as ofTrueTypeFont, y is the baseline
+    ofRectangle getStringBoundingBox(const std::string &s, double x, double y) {
+        double pen = 0, minx = 1e9, maxx = -1e9, miny = 1e9, maxy = -1e9;
+        for(unsigned code : decode(s)) {
+            const glyph &g = getGlyph(code);
+            if(g.width && g.height) {
+                minx = std::min(minx, pen + g.left);
+                maxx = std::max(maxx, pen + g.left + g.width);
+                miny = std::min(miny, (double)-g.top);
+                maxy = std::max(maxy, (double)-g.top + g.height);
+            }
+            pen += g.advance;
+        }
+        if(minx > maxx) return ofRectangle(x, y, 0, 0);
+        return ofRectangle(x + minx, y + miny, maxx - minx, maxy - miny);
+    }
+
+    ofTrueTypeFont &gl() {
+        if(!gl_loaded) {
+            ofTrueTypeFontSettings settings(file, size);
+            settings.antialiased = true;
+            for(auto &r : ranges) settings.addRange(r);
+            gl_font.load(settings);
+            gl_loaded = true;
+        }
+        return gl_font;
+    }
+
+    static std::vector<unsigned> decode(const std::string &s) { //utf-8 to code points
+        std::vector<unsigned> codes;
+        for(size_t i = 0; i < s.size();) {
+            unsigned char c = s[i];
+            int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+            unsigned code = extra ? c & (0x3F >> extra) : c;
+            for(int j = 1; j <= extra && i + j < s.size(); j++)
+                code = (code << 6) | (s[i + j] & 0x3F);
+            codes.push_back(code);
+            i += extra + 1;
+        }
+        return codes;
+    }
+
+private:
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+    std::map<unsigned, glyph> glyphs;
+    std::mutex lock;
+    ofTrueTypeFont gl_font;
+    bool gl_loaded = false;
+};
+
+//fonts are loaded once per process and shared, loading them was a big part of short renders
+inline typeface &loadTypeface(const std::string &file, int size, const std::vector<ofUnicode::range> &ranges = {}) {
+    static std::mutex lock;
+    static std::map<std::tuple<std::string, int, std::vector<std::pair<unsigned, unsigned> > >, std::unique_ptr<typeface> > cache;
+    std::vector<std::pair<unsigned, unsigned> > glyphs; //the same file and size with other ranges is another font
+    for(auto &r : ranges) glyphs.push_back({r.begin, r.end});
+    std::lock_guard<std::mutex> guard(lock);
+    auto &font = cache[std::make_tuple(file, size, glyphs)];
+    if(!font) {
+        font.reset(new typeface());
+        for(auto &r : ranges) font->addRange(r);
+        font->load(file, size);
+    }
+    return *font;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+//finished images are encoded and written on a background thread, so the next render can start
+//while the last one is still being compressed
+//only so many may be waiting at once, submit blocks when that many are, so memory stays bounded
+//every file goes through a temporary name, is fsynced and then renamed into place,
+//so a file that's there is complete, even after a crash
+
+#include "pool.h"
+#include <atomic>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <string>
+#include <unistd.h>
+
+//queue nodes on other machines write into the same directories, and can have the same pid
+inline const std::string &hostName() {
+    static const std::string host = [] {
+        char name[256] = "";
+        gethostname(name, sizeof(name)-1);
+        return std::string(name);
+    }();
+    return host;
+}
+
+//next to path with the same extension, the encoder picks the format by it
+inline std::string temporaryPath(const std::string &path) {
+    auto slash = path.rfind('/');
+    auto dot = path.rfind('.');
+    std::string dir = (slash == std::string::npos ? "" : path.substr(0, slash + 1));
+    std::string ext = (dot == std::string::npos || (slash != std::string::npos && dot < slash) ? "" : path.substr(dot));
+    static std::atomic<int> count(0); //several threads can be writing into one directory
+    return dir + ".tmp-" + hostName() + "-" + std::to_string(getpid()) + "-" + std::to_string(count++) + ext;
+}
+
+inline bool syncPath(const std::string &path) { //works on directories too
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+//flush tmp to disk, rename it over path and flush the directory so the rename sticks
+inline bool commitFile(const std::string &tmp, const std::string &path) {
+    if(!syncPath(tmp) || rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    auto slash = path.rfind('/');
+    syncPath(slash == std::string::npos ? "." : path.substr(0, slash + 1));
+    return true;
+}
+
+inline bool writeFile(const std::string &path, const std::string &contents) {
+    std::string tmp = temporaryPath(path);
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        out << contents;
+        if(!out) {
+            unlink(tmp.c_str());
+            return false;
+        }
+    }
+    return commitFile(tmp, path);
+}
+
+struct image_writer {
+    //one thread is enough to keep up with several renders, encoders aren't all safe to run at once anyway
+    image_writer(int _capacity = 4, int threads = 1) : capacity(std::max(1, _capacity)), pool(threads) {}
+
+    ~image_writer() {
+        wait();
+    }
+
+    //run f on the writer, after waiting for room if capacity jobs are already queued or running
+    //the future says whether it worked
+    std::future<bool> submit(std::function<bool()> f) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            room.wait(guard, [this] { return queued < capacity; });
+            queued++;
+        }
+        auto done = std::make_shared<std::promise<bool> >();
+        pool.submit([this, f, done] {
+            bool ok = false;
+            try {
+                ok = f();
+            } catch(...) {}
+            done->set_value(ok);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                queued--;
+            }
+            room.notify_all();
+        });
+        return done->get_future();
+    }
+
+    void wait() { //until everything submitted is written
+        pool.wait();
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable room;
+    int capacity, queued = 0;
+    thread_pool pool; //last, so its threads are gone before the rest is
+};
@@ -0,0 +1,141 @@
+#include "ofMain.h"
+#include "../../common/canvas.h"
+#include "../../common/encoder.h"
+#include "../../common/resize.h"
+#include <dirent.h>
+
+//a contact sheet of a directory of renders, a thumbnail of each labelled with its seed, to pick seeds from
+//usage: contact dir [-o sheet.png] [-t thumbnail side] [-c columns]
+//renders are found by the .stats sidecars next to them, and each thumbnail is made from the smallest
+//of its sizes (-sizes in batch) that's at least as big, or the full image, png before jpg
+//the sheet is made and written a row of thumbnails at a time, one image open at a time,
+//so a batch of any size fits in memory
+
+int thumb = 270; //longest side
+int columns = 8;
+int gap = 16; //around thumbnails
+int label = 28; //under each for its seed
+
+struct entry {
+    string sketch, seed, image;
+};
+
+//the image a render's thumbnail should come from, empty when none of its files are there
+string source(const string &dir, const map<string, string> &stats) {
+    auto formats = stats.count("formats") ? stats.at("formats") : "jpg";
+    vector<int> sizes;
+    try {
+        if(stats.count("sizes")) sizes = imageSizes(stats.at("sizes"));
+    } catch(std::invalid_argument &) {}
+    sort(sizes.begin(), sizes.end());
+    string base = dir + "/" + stats.at("seed");
+    vector<string> bases;
+    for(int s : sizes)
+        if(s >= thumb) bases.push_back(base + "-" + to_string(s));
+    bases.push_back(base);
+    for(auto &b : bases)
+        for(string ext : {"png", "jpg"})
+            if(formats.find(ext) != string::npos && ifstream(b + "." + ext)) return b + "." + ext;
+    return "";
+}
+
+vector<entry> find(const string &dir) {
+    vector<entry> entries;
+    DIR *d = opendir(dir.c_str());
+    if(!d) {
+        cerr << "can't open " << dir << endl;
+        return entries;
+    }
+    while(auto e = readdir(d)) {
+        string file = e->d_name;
+        if(file.size() < 6 || file.substr(file.size()-6) != ".stats") continue;
+        ifstream in(dir + "/" + file);
+        map<string, string> stats;
+        string line;
+        while(getline(in, line)) {
+            auto eq = line.find('=');
+            if(eq != string::npos) stats[line.substr(0, eq)] = line.substr(eq+1);
+        }
+        if(!stats.count("seed")) continue;
+        string image = source(dir, stats);
+        if(image.empty()) cerr << "no image for " << file << endl;
+        else entries.push_back({stats["sketch"], stats["seed"], image});
+    }
+    closedir(d);
+    sort(entries.begin(), entries.end(), [](const entry &a, const entry &b) {
+        return a.sketch != b.sketch ? a.sketch < b.sketch : a.seed < b.seed;
+    });
+    return entries;
+}
+
+int main(int argc, char *argv[]){
+    string dir, out;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-o" && i+1 < argc) out = argv[++i];
+        else if(arg == "-t" && i+1 < argc) thumb = max(16, stoi(argv[++i]));
+        else if(arg == "-c" && i+1 < argc) columns = max(1, stoi(argv[++i]));
+        else dir = arg;
+    }
+    if(dir.empty()) {
+        cerr << "usage: contact dir [-o sheet.png] [-t thumbnail side] [-c columns]" << endl;
+        return 2;
+    }
+    if(out.empty()) out = dir + "/contact.png";
+
+    auto entries = find(dir);
+    if(entries.empty()) {
+        cerr << "no renders in " << dir << endl;
+        return 1;
+    }
+    columns = min(columns, (int)entries.size());
+    int rows = (entries.size() + columns - 1) / columns;
+    int cell_w = thumb + gap, cell_h = thumb + gap + label;
+    int width = columns * cell_w + gap, height = rows * cell_h + gap;
+
+    typeface &font = loadTypeface("sans.ttf", 16);
+    png_stream<unsigned char> sheet(out, width, height);
+    cpu_canvas band;
+    vector<unsigned char> row((size_t)width * 3);
+    int failed = 0;
+    for(int r = 0; r < rows; r++) {
+        int top = (r == 0 ? gap : 0); //the gap above the first row, the rest have theirs below the label
+        band.allocate(width, top + cell_h);
+        band.background(ofColor(30));
+        for(int c = 0; c < columns && r * columns + c < entries.size(); c++) {
+            auto &e = entries[r * columns + c];
+            int x = gap + c * cell_w, y = top;
+            ofPixels pix;
+            if(!ofLoadImage(pix, e.image)) {
+                cerr << "can't read " << e.image << endl;
+                failed++;
+                continue;
+            }
+            ofPixels small = downscale(pix, thumb);
+            pix.clear(); //only one full image open at a time
+            int w = small.getWidth(), h = small.getHeight(), ch = small.getNumChannels();
+            int ox = x + (thumb - w) / 2, oy = y + (thumb - h) / 2;
+            band.enableBlendMode(OF_BLENDMODE_DISABLED);
+            for(int j = 0; j < h; j++)
+                for(int i = 0; i < w; i++) {
+                    const unsigned char *p = small.getData() + ((size_t)j * w + i) * ch;
+                    band.setColor(ofColor(p[0], p[1], p[2]));
+                    band.drawPoint(ox + i, oy + j);
+                }
+            band.enableBlendMode(OF_BLENDMODE_ALPHA);
+            band.setColor(ofColor(230));
+            ofRectangle bounds = font.getStringBoundingBox(e.seed, 0, 0);
+            band.drawString(font, e.seed, x + (thumb - bounds.width) / 2 - bounds.x, y + thumb + gap / 2 + label / 2 - bounds.y - bounds.height / 2);
+        }
+        for(int y = 0; y < band.height; y++) {
+            band.readRow(y, row.data());
+            sheet.add(row.data());
+        }
+    }
+    if(!sheet.close()) {
+        cerr << "couldn't write " << out << endl;
+        return 1;
+    }
+    printf("%d renders, %d columns, %dx%d, in %s\n", (int)entries.size() - failed, columns, width, height, out.c_str());
+    return failed ? 1 : 0;
+}
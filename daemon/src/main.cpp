@@ -0,0 +1,23 @@
+#include "ofMain.h"
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+//========================================================================
+int main(int argc, char *argv[]){
+    //usage: daemon [-s socket] [-j threads] [-o dir] [-c cachedir]
+    auto app = std::make_shared<ofApp>();
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-s" && i+1 < argc) app->path = argv[++i];
+        else if(arg == "-j" && i+1 < argc) app->threads = stoi(argv[++i]);
+        else if(arg == "-o" && i+1 < argc) app->dir = string(argv[++i]) + "/";
+        else if(arg == "-c" && i+1 < argc) app->cache_dir = string(argv[++i]) + "/";
+    }
+
+    ofWindowSettings settings;
+    auto window = std::make_shared<ofAppNoWindow>();
+    window->setup(settings);
+    ofGetMainLoop()->addWindow(window);
+    ofRunApp(window, app);
+    ofRunMainLoop();
+}
@@ -0,0 +1,220 @@
+#include "ofApp.h"
+#include "../../common/sketches.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+    //warm up the fonts every sketch will ask for
+    loadTypeface("sans.ttf", 30);
+    hexgrid_sketch().loadAllFonts();
+
+    pool = std::make_unique<thread_pool>(threads);
+    writer = std::make_unique<image_writer>(pool->size());
+    cache = std::make_unique<render_cache>(cache_dir);
+
+    server = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+    unlink(path.c_str()); //left over from a daemon that didn't exit cleanly
+    if(server < 0 ||
+       ::bind(server, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+       listen(server, 16) < 0) {
+        cerr << "can't listen on " << path << ": " << strerror(errno) << endl;
+        ofExit(1);
+        return;
+    }
+    cout << "listening on " << path << " with " << pool->size() << " threads" << endl;
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+    if(server < 0) return;
+    int client = accept(server, nullptr, nullptr); //blocks until someone asks for an image
+    if(client < 0) return;
+    //each connection is read on its own thread, only renders go to the pool,
+    //so clients that sit connected without asking for anything can't hold up the rest
+    for(auto c = connections.begin(); c != connections.end();) { //the ones that have hung up
+        if(!c->done) {
+            ++c;
+            continue;
+        }
+        c->reader.join();
+        close(c->client);
+        c = connections.erase(c);
+    }
+    connections.emplace_back();
+    auto &c = connections.back();
+    c.client = client;
+    c.reader = std::thread([this, &c] {
+        serve(c.client);
+        c.done = true;
+    });
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+
+}
+
+//--------------------------------------------------------------
+void ofApp::exit(){
+    if(server >= 0) {
+        close(server);
+        unlink(path.c_str());
+    }
+    for(auto &c : connections) shutdown(c.client, SHUT_RD); //ends their reads, what they asked for is still answered
+    for(auto &c : connections) {
+        c.reader.join();
+        close(c.client);
+    }
+    connections.clear();
+    pool.reset(); //lets running jobs finish
+    writer.reset(); //and then what they left to write
+}
+
+//--------------------------------------------------------------
+void ofApp::serve(int client){ //answers every line in order, the renders run on the pool meanwhile
+    std::deque<std::future<string> > replies;
+    auto answer = [&](bool all) { //send the finished replies, or wait for every one when all
+        while(!replies.empty() && (all || replies.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+            string reply = replies.front().get() + "\n";
+            send(client, reply.c_str(), reply.size(), MSG_NOSIGNAL);
+            replies.pop_front();
+        }
+    };
+
+    string line;
+    char c;
+    while(true) {
+        pollfd next = {client, POLLIN, 0};
+        if(!replies.empty() && poll(&next, 1, 0) == 0) answer(true); //nothing else asked for, the client is waiting on us
+        if(read(client, &c, 1) != 1) break;
+        if(c != '\n') {
+            line += c;
+            continue;
+        }
+        replies.push_back(handle(line));
+        line.clear();
+        answer(false);
+    }
+    answer(true);
+}
+
+//--------------------------------------------------------------
+std::future<string> ofApp::handle(const string &request){
+    auto start = std::chrono::steady_clock::now();
+    auto since = [](std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-t).count();
+    };
+    auto reply = std::make_shared<std::promise<string> >();
+    auto now = [&](const string &r) {
+        reply->set_value(r);
+        return reply->get_future();
+    };
+
+    string name;
+    unsigned int seed = std::random_device()();
+    long long budget = 0;
+    vector<image_format> formats = defaultFormats();
+    vector<int> sizes = defaultSizes();
+    std::stringstream words(request);
+    string word;
+    while(words >> word) {
+        auto eq = word.find('=');
+        if(eq == string::npos) return now("error expected key=value, got " + word);
+        string key = word.substr(0, eq), value = word.substr(eq+1);
+        try {
+            if(key == "sketch") name = value;
+            else if(key == "seed") seed = stoul(value, nullptr, 16);
+            else if(key == "budget") budget = stoll(value);
+            else if(key == "format") formats = imageFormats(value);
+            else if(key == "sizes") sizes = imageSizes(value);
+            else return now("error unknown key " + key);
+        } catch(std::invalid_argument &e) {
+            return now(key == "format" || key == "sizes" ? string("error ") + e.what() : "error bad value for " + key);
+        } catch(std::exception &) {
+            return now("error bad value for " + key);
+        }
+    }
+
+    auto generator = std::shared_ptr<sketch>(makeSketch(name));
+    if(!generator) return now("error unknown sketch " + name);
+    generator->formats = formats;
+    generator->sizes = sizes;
+
+    std::stringstream seedstring;
+    seedstring << std::hex << seed;
+    string base = dir + seedstring.str(), file;
+    for(auto &f : formats) {
+        file += (file.empty() ? "" : ",") + base + "." + f.ext;
+        for(int size : sizes) file += "," + sizedPath(base, size, f);
+    }
+    string key = renderKey(*generator, seed, budget);
+    if(cache->has(key, formats, sizes)) {
+        if(!cache->place(key, base, formats, sizes)) return now("error can't write " + file);
+        return now("ok path=" + file + " cached=1 total=" + ofToString(since(start)));
+    }
+
+    //a job that throws answers with an error, the pool's threads and the reader waiting on reply carry on
+    pool->submit([=] {
+        long long setup_time, render_time;
+        string manifest;
+        std::shared_ptr<image_pixels> pix;
+        try {
+            std::unique_ptr<canvas> buffer;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if(!canvases.empty()) {
+                    buffer = std::move(canvases.back());
+                    canvases.pop_back();
+                }
+            }
+            if(!buffer) buffer = std::make_unique<cpu_canvas>();
+
+            generator->start(seed, std::move(buffer), budget);
+            manifest = generator->manifest();
+            setup_time = since(start);
+
+            auto t = std::chrono::steady_clock::now();
+            generator->render();
+            render_time = since(t);
+
+            pix = std::make_shared<image_pixels>(generator->readback());
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                canvases.push_back(std::move(generator->buffer)); //free for the next job while this one is written
+            }
+        } catch(std::exception &e) {
+            reply->set_value(string("error can't render: ") + e.what());
+            return;
+        } catch(...) {
+            reply->set_value("error can't render");
+            return;
+        }
+
+        writer->submit([=] {
+            auto t = std::chrono::steady_clock::now();
+            bool written;
+            try {
+                written = cache->store(*generator, *pix, key, manifest) && cache->place(key, base, formats, sizes);
+            } catch(...) {
+                written = false;
+            }
+            if(!written) {
+                reply->set_value("error can't write " + file);
+                return false;
+            }
+            reply->set_value("ok path=" + file +
+                " setup=" + ofToString(setup_time) +
+                " render=" + ofToString(render_time) +
+                " save=" + ofToString(since(t)) +
+                " total=" + ofToString(since(start)));
+            return true;
+        });
+    });
+    return reply->get_future();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofMain.h"
+#include "../../common/canvas.h"
+#include "../../common/pool.h"
+#include "../../common/cache.h"
+#include "../../common/writer.h"
+#include <list>
+
+//long running renderer, takes one job per line over a unix socket
+//  sketch=fujii seed=0x56798ae7 budget=3000000
+//and answers with a line like
+//  ok path=../images/56798ae7.jpg setup=12 render=5210 save=95 total=5317
+//times are in milliseconds, budget is optional
+//format=jpg,png16 picks what's written (see encoder.h) and sizes=1080,540 the smaller copies,
+//path then lists every file
+//an image that's already in the cache is answered with cached=1 and no timings
+//lines can be sent without waiting for answers, the next one renders while the last is written
+//and the answers come back in order
+
+class ofApp : public ofBaseApp{
+
+	public:
+        string path = "/tmp/art-automata.sock";
+        string dir = "../images/";
+        string cache_dir = "../cache/";
+        int threads = 0; //0 is one per core
+
+		void setup();
+		void update();
+		void draw();
+		void exit();
+
+    private:
+        int server = -1;
+        std::unique_ptr<thread_pool> pool;
+        std::unique_ptr<render_cache> cache;
+        std::unique_ptr<image_writer> writer;
+        std::mutex lock;
+        vector<std::unique_ptr<canvas> > canvases; //finished canvases, kept allocated for the next job
+
+        struct connection {
+            int client = -1;
+            std::thread reader; //runs serve, closing the socket is left to whoever joins it
+            std::atomic<bool> done{false};
+        };
+        std::list<connection> connections; //only touched from the main thread
+
+        void serve(int client);
+        std::future<string> handle(const string &request); //ready once the image is written
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+//3d fractal flames seen through a camera with depth of field
+
+#include "../../common/sketch.h"
+#include "../../common/camera.h"
+#include "../../common/palette.h"
+#include "flame.h"
+
+struct field_sketch : sketch {
+    field_sketch() : sketch("field", 1000, 1000, 4) {} //2: ziggurat gaussians, 3: philox streams, 4: border stencil
+
+    int iterations = 800;
+    int samples = 10;
+
+    typeface *font;
+
+    ofVec3f cam;
+    vector<field::fract> fractals;
+    vector<rng> streams; //one for each fractal's chaos game and the points it splats
+    vector<string> vars;
+    vector<double> base_hues;
+    camera view;
+    vector<ofVec3f> points; //a step of every fractal
+    vector<float> xs, ys, zs; //the points or a round of samples around them
+    vector<double> depths, alphas, radii, screen_x, screen_y; //a sample of each fractal after another
+    vector<char> inside; //which samples made it past the border
+    palette shades;
+    vector<double> hues, sats;
+    vector<ofFloatColor> colors; //each fractal's, its hue moves as it steps
+
+    //these are for depth of field, refer to inconvergent's tutorial
+    //https://inconvergent.net/2019/depth-of-field/
+
+    double m = 0.07, e = 1.5;
+    double f = 0.85;
+    double fov = 15;
+
+    double noise_seed;
+
+    bool mult = 0;
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+        budget = 18000000; //chaos game iterations over all fractals, about what 25 seconds used to give
+        noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+
+        buffer->begin();
+        buffer->background(ofColor(10));
+        buffer->setColor(ofColor(240));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        buffer->end();
+
+        if(random(1) <= 0.4) mult = 1;
+
+        cam = ofVec3f(gaussian(0, 0.35), gaussian(0, 0.35), gaussian(0, 0.35)); //position camera close to origin
+
+        int var_number = random(2, 8);
+        for(int i = 1; i <= var_number; i++)
+            vars.push_back(field::randVariation(rnd));
+
+        double hue = random(1);
+        base_hues = {hue, fmod(hue+random(0.2, 0.8), 1), fmod(hue+random(0.2, 0.7), 1)};
+
+        int fract_number = 15;
+        for(int i = 1; i <= fract_number; i++) {
+            fractals.push_back(field::fract(rnd, vars, base_hues));
+            fractals.back().single = single;
+            streams.push_back(rnd.stream("fract", i));
+        }
+
+        m = random(0.01, 0.1);
+        e = random(1.2, 2.1);
+        f = random(0.75, 1.75);
+
+        fov = random(2, 6);
+
+        view = camera(cam, fov, width, height, mult);
+        view.glow = 0.05;
+        view.near = 1;
+        points.resize(fract_number);
+        xs.resize(fract_number), ys.resize(fract_number), zs.resize(fract_number);
+        depths.resize(fract_number), alphas.resize(fract_number), radii.resize(fract_number);
+        screen_x.resize(fract_number*samples), screen_y.resize(fract_number*samples), inside.resize(fract_number*samples);
+        hues.resize(fract_number), sats.resize(fract_number), colors.resize(fract_number);
+    }
+
+    ofVec3f rndSphere(rng &r, double radius) {
+        double phi = r.random(2*PI);
+        double costheta = r.random(-1, 1);
+        double u = r.random(0, 1);
+
+        double theta = acos(costheta);
+        double rad = radius * cbrt(u);
+
+        return ofVec3f(rad*sin(theta)*cos(phi), rad*sin(theta)*sin(phi), rad*cos(theta));
+    }
+
+    //every fractal takes a step, then blurs it into samples points, each fractal from its own stream
+    //a round of samples is projected for all the fractals at once, the fractals' streams are drawn from
+    //in the same order as one at a time, and their points drawn in the same order after
+    void update() {
+        trace_total splat(tracer, "splat");
+        int n = fractals.size();
+        buffer->begin();
+        for(int i = 1; i <= iterations && spent < budget; i++) {
+            for(int j = 0; j < n; j++) {
+                ofVec3f p = fractals[j].step(streams[j]);
+                spent++;
+                points[j] = p;
+                xs[j] = p.x, ys[j] = p.y, zs[j] = p.z;
+            }
+            view.depth(n, xs.data(), ys.data(), zs.data(), depths.data(), alphas.data()); //0.05 over the distance, from 1 away
+            for(int j = 0; j < n; j++) {
+                radii[j] = m*pow(abs(f-depths[j]), e);
+                hues[j] = fractals[j].hue;
+                sats[j] = min(fractals[j].sat+0.3, 0.8);
+            }
+            shades.lookup(n, hues.data(), sats.data(), colors.data());
+
+            splat.begin();
+            for(int k = 0; k < samples; k++) {
+                for(int j = 0; j < n; j++) {
+                    auto w = points[j]+rndSphere(streams[j], radii[j]);
+                    xs[j] = w.x, ys[j] = w.y, zs[j] = w.z;
+                }
+                view.project(n, xs.data(), ys.data(), zs.data(), depths.data(), screen_x.data() + k*n, screen_y.data() + k*n);
+                for(int j = 0; j < n; j++) {
+                    inside[k*n+j] = margins.inside(streams[j], screen_x[k*n+j], screen_y[k*n+j]); //borders
+                }
+            }
+            for(int j = 0; j < n; j++) {
+                buffer->enableBlendMode(OF_BLENDMODE_ADD);
+                ofFloatColor c = colors[j];
+                c.a = alphas[j];
+                buffer->setColor(c);
+                for(int k = 0; k < samples; k++) {
+                    if(inside[k*n+j]) {
+                        buffer->drawPoint(screen_x[k*n+j], screen_y[k*n+j]);
+                        stats.points++;
+                    }
+                    else stats.rejected++;
+                }
+            }
+            splat.end();
+        }
+        buffer->end();
+
+        long long resets = 0;
+        for(auto &fr : fractals) resets += fr.resets;
+        stats.counts["nan_resets"] = resets;
+    }
+
+    bool done() {
+        return spent >= budget;
+    }
+
+    void persist(archive &a) {
+        for(auto &fr : fractals) a.io(fr.v, fr.hue, fr.sat, fr.resets);
+        a.io(streams);
+    }
+
+    void describe(std::ostream &out) {
+        out << "noise_seed=" << noise_seed << "\n";
+        out << "mult=" << mult << "\n";
+        out << "cam=" << cam.x << "," << cam.y << "," << cam.z << "\n";
+        out << "m=" << m << "\n";
+        out << "e=" << e << "\n";
+        out << "f=" << f << "\n";
+        out << "fov=" << fov << "\n";
+        out << "vars=" << join(vars) << "\n";
+        out << "base_hues=" << join(base_hues) << "\n";
+        for(int i = 0; i < fractals.size(); i++)
+            fractals[i].describe(out, "fract" + ofToString(i));
+    }
+};
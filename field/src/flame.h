@@ -4,7 +4,10 @@
 //https://flam3.com/flame_draves.pdf
 //https://tigerprints.clemson.edu/cgi/viewcontent.cgi?article=2704&context=all_theses
 
-#include "ofApp.h"
+#include "ofMain.h"
+#include "../../common/rng.h"
+
+namespace field {
 
 #define R sqrt(v.x*v.x+v.y*v.y+v.z*v.z)
 #define R1 sqrt(v.x*v.x+v.y*v.y)
@@ -40,11 +43,14 @@ ofVec3f julia(ofVec3f v) {
     return sqrt(R)*ofVec3f(cos(O/2), sin(O/2), sin(O2/2));
 }
 
-ofVec3f wave(ofVec3f v, vector<double> aff) {
+//aff is double, or float with ART_FLOAT
+template<typename T>
+ofVec3f wave(ofVec3f v, const vector<T> &aff) {
     return ofVec3f(v.x+aff[1]*sin(v.y/(aff[2]*aff[2])), v.y+aff[3]*sin(v.x/(aff[4]*aff[4])), v.z+aff[5]*sin(v.z/(aff[6]*aff[6])));
 }
 
-ofVec3f popcorn(ofVec3f v, vector<double> aff) {
+template<typename T>
+ofVec3f popcorn(ofVec3f v, const vector<T> &aff) {
     return ofVec3f(v.x+aff[1]*sin(tan(3*v.y)), v.y+aff[2]*sin(tan(3*v.z)), v.z+aff[3]*sin(tan(3*v.x)));
 }
 
@@ -104,20 +110,24 @@ ofVec3f exponential(ofVec3f v) {
 #undef O
 #undef O2
 
-vector<string> chosen_vars;
-
-string randVariation() {
-    vector<string> v = {
+const vector<string> &variations() {
+    static const vector<string> v = {
         "sinusoidal", "spiral", "swirl",  "hyperbolic",
         "wave", "popcorn", "horseshoe", "handkerchief",
         "diamond",  "cosine" , "polar", "heart",
         "disc", "julia", "ex", "spherical",
         "power", "bent", "exponential"
     };
-    return v[(int)ofRandom(v.size()-0.01)];
+    return v;
+}
+
+string randVariation(rng &r) {
+    auto &v = variations();
+    return v[(int)r.random(v.size()-0.01)];
 }
 
-ofVec3f resolveVariation(string name, ofVec3f v, vector<double> aff) {
+template<typename T>
+ofVec3f resolveVariation(const string &name, ofVec3f v, const vector<T> &aff) {
     if(name == "sinusoidal") return sinusoidal(v);
     else if(name == "spiral") return spiral(v);
     else if(name == "swirl") return swirl(v);
@@ -140,21 +150,24 @@ ofVec3f resolveVariation(string name, ofVec3f v, vector<double> aff) {
     else return v;
 }
 
-ofVec3f affine(ofVec3f v, vector<double> a) {
+template<typename T>
+ofVec3f affine(ofVec3f v, const vector<T> &a) {
     return ofVec3f(v.x*a[0]+v.y*a[1]+v.z*a[2]+a[3], v.x*a[4]+v.y*a[5]+v.z*a[6]+a[7], v.x*a[8]+v.y*a[9]+v.z*a[10]+a[11]);
 }
 
-string chooseVariation(vector<string> vars) {
-    if(!vars.size()) return randVariation();
-    return vars[(int)ofRandom(vars.size()-0.01)];
+string chooseVariation(rng &r, vector<string> vars) {
+    if(!vars.size()) return randVariation(r);
+    return vars[(int)r.random(vars.size()-0.01)];
 }
 
 struct func {
     int len;
     vector<double> aff, post, weight;
+    vector<float> single_aff, single_post; //rounded to float, for ART_FLOAT
     vector<string> vars;
     
-    ofVec3f resolve(ofVec3f v) {
+    template<typename T>
+    ofVec3f resolve(ofVec3f v, const vector<T> &aff, const vector<T> &post) {
         ofVec3f w(0, 0, 0);
         for(int i = 0; i < len; i++) {
             ofVec3f s = weight[i]*resolveVariation(vars[i], affine(v, aff), aff);
@@ -163,48 +176,68 @@ struct func {
         return affine(w, post);
     }
     
-    func() {
-        len = ofRandom(1, 8);
+    ofVec3f resolve(ofVec3f v, bool single = false) {
+        return single ? resolve(v, single_aff, single_post) : resolve(v, aff, post);
+    }
+    
+    void narrow() {
+        single_aff.assign(aff.begin(), aff.end());
+        single_post.assign(post.begin(), post.end());
+    }
+    
+    void describe(std::ostream &out, const string &prefix) {
+        out << prefix << ".vars=" << join(vars) << "\n";
+        out << prefix << ".weight=" << join(weight) << "\n";
+        out << prefix << ".aff=" << join(aff) << "\n";
+        out << prefix << ".post=" << join(post) << "\n";
+    }
+    
+    func() {}
+    
+    func(rng &r) {
+        len = r.random(1, 8);
         for(int i = 1; i <= 12; i++)
-            post.push_back(ofRandom(0, 1.2)*(ofRandom(1) <= 0.5 ? -1 : 1)),
-            aff.push_back(ofRandom(0, 1.2)*(ofRandom(1) <= 0.5 ? -1 : 1));
+            post.push_back(r.random(0, 1.2)*(r.random(1) <= 0.5 ? -1 : 1)),
+            aff.push_back(r.random(0, 1.2)*(r.random(1) <= 0.5 ? -1 : 1));
         for(int i = 1; i <= len; i++)
             weight.push_back(0),
-            vars.push_back(randVariation());
+            vars.push_back(randVariation(r));
         double w_sum = 0, w_inc = 0.05;
         while(w_sum < 1) {
-            weight[(int)ofRandom(len)] += w_inc;
+            weight[(int)r.random(len)] += w_inc;
             w_sum += w_inc;
         }
+        narrow();
     }
     
-    func(vector<string> available_vars) {
-        len = ofRandom(1, 8);
+    func(rng &r, vector<string> available_vars) {
+        len = r.random(1, 8);
         for(int i = 1; i <= 12; i++)
-            post.push_back(ofRandom(1.2)*(ofRandom(1) <= 0.5 ? -1 : 1)),
-            aff.push_back(ofRandom(1.2)*(ofRandom(1) <= 0.5 ? -1 : 1));
+            post.push_back(r.random(1.2)*(r.random(1) <= 0.5 ? -1 : 1)),
+            aff.push_back(r.random(1.2)*(r.random(1) <= 0.5 ? -1 : 1));
         for(int i = 1; i <= len; i++)
             weight.push_back(0),
-            vars.push_back(chooseVariation(available_vars));
+            vars.push_back(chooseVariation(r, available_vars));
         double w_sum = 0, w_inc = 0.05;
         while(w_sum < 1) {
-            weight[(int)ofRandom(len)] += w_inc;
+            weight[(int)r.random(len)] += w_inc;
             w_sum += w_inc;
         }
+        narrow();
     }
 };
 
-vector<double> base_hues;
-
 struct fract {
     vector<double> f_weight, hues, sats;
     vector<func> funcs;
     ofVec3f v;
     func fin;
-    double hue, sat;
+    double hue = 0, sat = 0;
+    long long resets = 0; //times v blew up and was started again
+    bool single = false; //funcs resolved in float
     
-    int weightedRand() {
-        double r = ofRandom(1), w = 0;
+    int weightedRand(rng &rnd) {
+        double r = rnd.random(1), w = 0;
         for(int i = 0; i < f_weight.size(); i++) {
             w += f_weight[i];
             if(r <= w) return i;
@@ -212,32 +245,43 @@ struct fract {
         return 0;
     }
     
-    fract(vector<string> chosen_vars) {
-        int func_number = ofRandom(2, 15);
+    fract(rng &r, vector<string> chosen_vars, const vector<double> &base_hues) {
+        int func_number = r.random(2, 15);
         for(int i = 1; i <= func_number; i++) {
-            funcs.push_back(func(chosen_vars));
+            funcs.push_back(func(r, chosen_vars));
             f_weight.push_back(0);
-            hues.push_back(base_hues[(int)ofRandom(base_hues.size())]);
-            sats.push_back(ofRandom(1.0));
+            hues.push_back(base_hues[(int)r.random(base_hues.size())]);
+            sats.push_back(r.random(1.0));
         }
         double f_sum = 0, f_inc = 0.5;
         while(f_sum < 0.99) {
-            f_weight[(int)ofRandom(func_number)] += f_inc;
+            f_weight[(int)r.random(func_number)] += f_inc;
             f_sum += f_inc;
             f_inc /= 2;
         }
-        fin = func(chosen_vars);
-        v = ofVec3f(ofRandom(-1, 1), ofRandom(-1, 1), ofRandom(-1, 1));
+        fin = func(r, chosen_vars);
+        v = ofVec3f(r.random(-1, 1), r.random(-1, 1), r.random(-1, 1));
     }
     
-    ofVec3f step() {
-        if(isnan(v.x) || isnan(v.y) || isnan(v.z)) v = ofVec3f(ofRandom(-1, 1), ofRandom(-1, 1), ofRandom(-1, 1));
+    void describe(std::ostream &out, const string &prefix) {
+        out << prefix << ".weight=" << join(f_weight) << "\n";
+        out << prefix << ".hues=" << join(hues) << "\n";
+        out << prefix << ".sats=" << join(sats) << "\n";
+        for(int i = 0; i < funcs.size(); i++)
+            funcs[i].describe(out, prefix + ".func" + ofToString(i));
+        fin.describe(out, prefix + ".final");
+    }
+    
+    ofVec3f step(rng &r) {
+        if(isnan(v.x) || isnan(v.y) || isnan(v.z)) v = ofVec3f(r.random(-1, 1), r.random(-1, 1), r.random(-1, 1)), resets++;
         
-        int id = weightedRand();
+        int id = weightedRand(r);
         hue = (hue+hues[id])/2;
         sat = (sat+sats[id])/2;
-        v = funcs[id].resolve(v);
-        v = fin.resolve(v);
+        v = funcs[id].resolve(v, single);
+        v = fin.resolve(v, single);
         return v;
     }
 };
+
+}
@@ -1,8 +1,10 @@
 #pragma once
 
-#include "ofApp.h"
+#include "ofMain.h"
+#include "../../common/rng.h"
+#include "../../common/noise.h"
 
-vector<double> aff;
+namespace flow {
 
 #define R sqrt(v.x*v.x+v.y*v.y+v.z*v.z)
 #define R1 sqrt(v.x*v.x+v.y*v.y)
@@ -38,11 +40,11 @@ ofVec3f julia(ofVec3f v) {
     return sqrt(R)*ofVec3f(cos(O/2), sin(O/2), sin(O2/2));
 }
 
-ofVec3f wave(ofVec3f v) {
+ofVec3f wave(ofVec3f v, const vector<double> &aff) {
     return ofVec3f(v.x+aff[1]*sin(v.y/(aff[2]*aff[2])), v.y+aff[3]*sin(v.x/(aff[4]*aff[4])), v.z+aff[5]*sin(v.z/(aff[6]*aff[6])));
 }
 
-ofVec3f popcorn(ofVec3f v) {
+ofVec3f popcorn(ofVec3f v, const vector<double> &aff) {
     return ofVec3f(v.x+aff[1]*sin(tan(3*v.y)), v.y+aff[2]*sin(tan(3*v.z)), v.z+aff[3]*sin(tan(3*v.x)));
 }
 
@@ -102,28 +104,31 @@ ofVec3f exponential(ofVec3f v) {
 #undef O
 #undef O2
 
-vector<string> chosen_vars;
-
-string randVariation() {
-    vector<string> v = {
+const vector<string> &variations() {
+    static const vector<string> v = {
         "sinusoidal", "spiral", "swirl",  "hyperbolic",
         "wave", "popcorn", "horseshoe", "handkerchief",
         "diamond",  "cosine" , "polar", "heart",
         "disc", "julia", "ex", "spherical",
         "power", "bent", "exponential"
     };
-    return v[(int)ofRandom(v.size()-0.01)];
+    return v;
+}
+
+string randVariation(rng &r) {
+    auto &v = variations();
+    return v[(int)r.random(v.size()-0.01)];
 }
 
-ofVec3f resolveVariation(string name, ofVec3f v) {
+ofVec3f resolveVariation(string name, ofVec3f v, const vector<double> &aff) {
     if(name == "sinusoidal") return sinusoidal(v);
     else if(name == "spiral") return spiral(v);
     else if(name == "swirl") return swirl(v);
     else if(name == "disc") return disc(v);
     else if(name == "hyperbolic") return hyperbolic(v);
     else if(name == "julia") return julia(v);
-    else if(name == "wave") return wave(v);
-    else if(name == "popcorn") return popcorn(v);
+    else if(name == "wave") return wave(v, aff);
+    else if(name == "popcorn") return popcorn(v, aff);
     else if(name == "horseshoe") return horseshoe(v);
     else if(name == "polar") return polar(v);
     else if(name == "handkerchief") return handkerchief(v);
@@ -137,60 +142,88 @@ ofVec3f resolveVariation(string name, ofVec3f v) {
     else if(name == "exponential") return exponential(v);
 }
 
-double noise_seed, noise_scale = 0.25, speed = 0.03;
-
-vector<pair<string, int> > formula;
-
-//this is basically polish notation
-//https://en.wikipedia.org/wiki/Polish_notation
-
-ofVec3f resolveFormula(ofVec3f v) {
-    ofVec3f w = resolveVariation(formula[0].first, v);
-    for(int i = 1; i < formula.size(); i++) {
-        if(formula[i].second == 0) w = resolveVariation(formula[i].first, w);
-        else if(formula[i].second == 1) w += resolveVariation(formula[i].first, v);
-        else if(formula[i].second == 2) w -= resolveVariation(formula[i].first, v);
-        else if(formula[i].second == 3) w *= resolveVariation(formula[i].first, v);
-        else w /= resolveVariation(formula[i].first, v);
+//everything the particles move through, set up once per seed
+struct vector_field {
+    vector<double> aff; //parameters used by some variations
+    double noise_seed, noise_scale = 0.25, speed = 0.03;
+    int octaves = 2;
+    vector<double> hues;
+    
+    vector<pair<string, int> > formula;
+    
+    //this is basically polish notation
+    //https://en.wikipedia.org/wiki/Polish_notation
+    
+    ofVec3f resolveFormula(ofVec3f v) {
+        ofVec3f w = resolveVariation(formula[0].first, v, aff);
+        for(int i = 1; i < formula.size(); i++) {
+            if(formula[i].second == 0) w = resolveVariation(formula[i].first, w, aff);
+            else if(formula[i].second == 1) w += resolveVariation(formula[i].first, v, aff);
+            else if(formula[i].second == 2) w -= resolveVariation(formula[i].first, v, aff);
+            else if(formula[i].second == 3) w *= resolveVariation(formula[i].first, v, aff);
+            else w /= resolveVariation(formula[i].first, v, aff);
+        }
+        return w;
     }
-    return w;
-}
-
-int octaves = 2;
-
-double getNoise(double x, double y, double z, double seed) {
-    double n = 0;
-    for(double i = 1, j = 1, k = 1; i <= octaves; i++, j /= 2, k *= 2)
-        n += j * ofNoise(x * k, y * k, z * k, seed);
-    return min(1.0, n);
-}
-
-ofVec3f sphereNoise(ofVec3f v) {
-    v *= noise_scale;
-    double phi = getNoise(v.x, v.y, v.z, noise_seed)*2*PI;
-    double costheta = getNoise(v.x, v.y, v.z, noise_seed+100)*2-1;
-    double u = getNoise(v.x, v.y, v.z, noise_seed+1000);
     
-    double theta = acos(costheta);
-    double rad = cbrt(u);
+    double getNoise(double x, double y, double z, double seed) {
+        float xs = x, ys = y, zs = z;
+        double n;
+        noise::fbm(1, &xs, &ys, &zs, seed, octaves, &n);
+        return min(1.0, n);
+    }
     
-    return ofVec3f(rad*sin(theta)*cos(phi), rad*sin(theta)*sin(phi), rad*cos(theta));
-}
-
-vector<double> hues;
+    ofVec3f sphereNoise(double phi, double costheta, double u) { //a point in the unit sphere from three noises
+        phi = phi*2*PI;
+        costheta = costheta*2-1;
+        
+        double theta = acos(costheta);
+        double rad = cbrt(u);
+        
+        return ofVec3f(rad*sin(theta)*cos(phi), rad*sin(theta)*sin(phi), rad*cos(theta));
+    }
+    
+    ofVec3f sphereNoise(ofVec3f v) {
+        v *= noise_scale;
+        return sphereNoise(getNoise(v.x, v.y, v.z, noise_seed), getNoise(v.x, v.y, v.z, noise_seed+100), getNoise(v.x, v.y, v.z, noise_seed+1000));
+    }
+    
+    //the same for every point in v at once, the noise is evaluated in batches
+    vector<float> xs, ys, zs;
+    vector<double> noises[3];
+    void sphereNoise(const vector<ofVec3f> &v, vector<ofVec3f> &out) {
+        int n = v.size();
+        xs.resize(n), ys.resize(n), zs.resize(n), out.resize(n);
+        for(int i = 0; i < n; i++) {
+            ofVec3f p = v[i] * noise_scale;
+            xs[i] = p.x, ys[i] = p.y, zs[i] = p.z;
+        }
+        double seeds[3] = {noise_seed, noise_seed+100, noise_seed+1000};
+        for(int j = 0; j < 3; j++) {
+            noises[j].resize(n);
+            noise::fbm(n, xs.data(), ys.data(), zs.data(), seeds[j], octaves, noises[j].data());
+        }
+        for(int i = 0; i < n; i++)
+            out[i] = sphereNoise(min(1.0, noises[0][i]), min(1.0, noises[1][i]), min(1.0, noises[2][i]));
+    }
+};
 
 struct particle {
     ofVec3f pos;
     double hue, sat;
     particle() {}
-    particle(ofVec3f p) : pos(p) {
+    particle(vector_field &f, ofVec3f p) : pos(p) {
         p /= 5;
-        hue = hues[(int)(getNoise(p.x, p.y, p.z, noise_seed)*3)];
-        sat = getNoise(p.x, p.y, p.z, noise_seed);
+        hue = f.hues[(int)(f.getNoise(p.x, p.y, p.z, f.noise_seed)*3)];
+        sat = f.getNoise(p.x, p.y, p.z, f.noise_seed);
     }
-    void update() {
-        auto v = sphereNoise(pos);
-        v = resolveFormula(v);
-        pos += v*speed;
+    void update(vector_field &f) {
+        update(f, f.sphereNoise(pos));
+    }
+    void update(vector_field &f, ofVec3f v) { //v is sphereNoise(pos), when it's been done for many particles at once
+        v = f.resolveFormula(v);
+        pos += v*f.speed;
     }
 };
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+//refer to generateme's blog post on vector fields, this is a 3d version of it
+//https://generateme.wordpress.com/
+
+#include "../../common/sketch.h"
+#include "../../common/camera.h"
+#include "flame.h"
+
+struct flow_sketch : sketch {
+    flow_sketch() : sketch("flow", 2000, 2000, 4) {} //2: ziggurat gaussians, 3: philox streams, 4: border stencil
+
+    typeface *font;
+
+    ofVec3f cam;
+    double fov = 2;
+
+    flow::vector_field field;
+    vector<flow::particle> particles;
+    vector<rng> streams; //one for each particle
+    vector<ofVec3f> positions, directions; //where the particles are and their noise, for a frame
+    camera view;
+    vector<float> xs, ys, zs; //where they've moved to
+    vector<double> screen_x, screen_y, depths, alphas; //and where that lands
+    vector<ofFloatColor> colors; //each particle's, they don't change
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+        budget = 240000000; //particle steps, roughly 1500 for each particle
+        field.noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+
+        buffer->begin();
+        buffer->background(ofColor(20));
+        buffer->setColor(ofColor(240));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        buffer->end();
+
+        cam = ofVec3f(gaussian(0, 0.01), gaussian(0, 0.01), -4); //position camera close to origin
+
+        fov = 0.3;
+        field.speed = random(0.015, 0.28);
+        field.octaves = random(2, 4);
+
+        int formula_length = random(1, 5);
+        for(int i = 1; i <= formula_length; i++)
+            field.formula.push_back({flow::randVariation(rnd), (int)random(5)});
+
+        for(int i = 1; i <= 12; i++) //parameters used by some variations
+            field.aff.push_back(random(1.2)*(random(1) <= 0.5 ? -1 : 1));
+
+        double hue = random(1);
+        field.hues = {hue, fmod(hue+random(0.2, 0.8), 1), random(1)};
+
+        //setup particles
+        double step = 0.15;
+        for(double x = -4; x <= 4; x += step)
+            for(double y = -4; y <= 4; y += step)
+                for(double z = -2; z <= 6; z += step) {
+                    particles.push_back(flow::particle(field, ofVec3f(x, y, z)));
+                    streams.push_back(rnd.stream("particle", particles.size()));
+                }
+        for(auto &i : particles) {
+            colors.emplace_back();
+            colors.back().setHsb(i.hue, min(i.sat+0.2, 0.8), 1);
+        }
+
+        view = camera(cam, fov, width, height);
+        view.divide = true;
+        view.glow = 0.2;
+        xs.resize(particles.size()), ys.resize(particles.size()), zs.resize(particles.size());
+        screen_x.resize(particles.size()), screen_y.resize(particles.size());
+        depths.resize(particles.size()), alphas.resize(particles.size());
+    }
+
+    void update() {
+        trace_total splat(tracer, "splat");
+        {
+            trace_scope batch(tracer, "noise"); //for every particle this frame will get to
+            positions.resize(min((long long)particles.size(), max(0LL, budget - spent)));
+            for(int j = 0; j < positions.size(); j++) positions[j] = particles[j].pos;
+            field.sphereNoise(positions, directions);
+        }
+        int n = positions.size();
+        for(int j = 0; j < n; j++) { //every particle moves, then they're all projected at once
+            particles[j].update(field, directions[j]);
+            xs[j] = particles[j].pos.x;
+            ys[j] = particles[j].pos.y;
+            zs[j] = particles[j].pos.z;
+        }
+        view.depthAndProject(n, xs.data(), ys.data(), zs.data(), screen_x.data(), screen_y.data(), depths.data(), alphas.data());
+
+        buffer->begin();
+        for(int j = 0; j < n; j++, spent++) {
+            buffer->enableBlendMode(OF_BLENDMODE_ADD);
+            ofFloatColor c = colors[j];
+            c.a = alphas[j]; //0.2 over the distance from the camera
+            buffer->setColor(c);
+            double xx = screen_x[j], yy = screen_y[j];
+            splat.begin();
+            if(margins.inside(streams[j], xx, yy)) { //borders
+                buffer->drawPoint(xx, yy);
+                stats.points++;
+            }
+            else stats.rejected++;
+            splat.end();
+        }
+        buffer->end();
+    }
+
+    bool done() {
+        return spent >= budget;
+    }
+
+    void persist(archive &a) { //colors don't change after setup
+        for(auto &p : particles) a.io(p.pos);
+        a.io(streams);
+    }
+
+    void describe(std::ostream &out) {
+        out << "noise_seed=" << field.noise_seed << "\n";
+        out << "noise_scale=" << field.noise_scale << "\n";
+        out << "speed=" << field.speed << "\n";
+        out << "octaves=" << field.octaves << "\n";
+        out << "cam=" << cam.x << "," << cam.y << "," << cam.z << "\n";
+        out << "fov=" << fov << "\n";
+        out << "formula=";
+        for(int i = 0; i < field.formula.size(); i++)
+            out << (i ? "," : "") << field.formula[i].first << ":" << field.formula[i].second;
+        out << "\n";
+        out << "aff=" << join(field.aff) << "\n";
+        out << "hues=" << join(field.hues) << "\n";
+    }
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+//refer to masaru fujii's formula for a strange attractor, this is a 3d version of it
+//https://how-to-build-du-e.tumblr.com/
+
+#include "../../common/sketch.h"
+#include "../../common/camera.h"
+#include "../../common/palette.h"
+
+//in T, double for the sketch and float with ART_FLOAT
+template<typename T>
+T sec(T x) { //secant
+    return T(1)/cos(x);
+}
+
+template<typename T>
+T square(T x) { //square wave
+    for(int i = 1; i <= 10; i++)
+        x = sin(x)*2;
+    return x/2;
+}
+
+template<typename T>
+T ssin(T x, int p) { //some cool periodic functions
+    if(p == -5) return square(sin(x)*2);
+    else if(p == -4) return (sec(sin(x))-T(1.5))*2;
+    else if(p == -3) return cos(sin(x)*T(M_PI));
+    else if(p == -2) return sin(sin(x)*2);
+    else if(p == -1) return abs(fmod(x, T(4))-2)-1;
+    else if(p == 0) return asin(sin(x))/T(M_PI/2);
+    else return T(pow(sin(x), p));
+}
+
+template<typename T>
+T ccos(T x, int p) {
+    if(p == -5) return square(cos(x)*2);
+    else if(p == -4) return (sec(cos(x))-T(1.5))*2;
+    else if(p == -3) return cos(cos(x)*T(M_PI));
+    else if(p == -2) return sin(cos(x)*2);
+    else if(p == -1) return abs(fmod(x+2, T(4))-2)-1;
+    else if(p == 0) return asin(cos(x))/T(M_PI/2);
+    else return T(pow(cos(x), p));
+}
+
+struct fujii_sketch : sketch {
+    fujii_sketch() : sketch("fujii", 2000, 2000, 4) {} //2: ziggurat gaussians, 3: philox streams, 4: border stencil
+
+    int iterations = 5000;
+
+    typeface *font;
+
+    double a[20], f[20], x = 0, y = 0, z = 0, t = 0, v;
+    int p[3];
+
+    double mind = 1000, maxd = -1000;
+    double avgx = 0, avgy = 0, avgz = 0;
+    bool mult = 0, dist = 1;
+    double fov = 8;
+
+    double noise_seed;
+
+    ofVec3f cam;
+    camera view;
+    vector<double> hues;
+    vector<double> xs, ys, zs, screen_x, screen_y, depths; //a frame's points and where they land
+    palette shades;
+    vector<double> point_hues, sats; //and their colors
+    vector<ofFloatColor> colors;
+
+    //one step of the attractor from the current point
+    void next(double &xx, double &yy, double &zz) {
+        xx = a[1]*ssin(f[1]*x, p[1]) + a[2]*ccos(f[2]*y, p[2]) + a[4]*ssin(f[4]*z, p[1]) + a[5]*ccos(f[5]*t, p[2]);
+        yy = a[6]*ccos(f[6]*x, p[2]) + a[7]*ssin(f[7]*y, p[1]) + a[8]*ccos(f[8]*z, p[2]) + a[8]*ssin(f[8]*t, p[1]);
+        zz = a[9]*ssin(f[9]*x, p[1]) + a[10]*ssin(f[10]*y, p[2]) + a[11]*ccos(f[11]*z, p[1]) + a[12]*ccos(f[12]*t, p[2]);
+    }
+
+    //the same in float, from the point and coefficients rounded to it
+    void next(float &xx, float &yy, float &zz) {
+        float a[13], f[13], x = this->x, y = this->y, z = this->z, t = this->t;
+        for(int i = 1; i <= 12; i++) a[i] = this->a[i], f[i] = this->f[i];
+        xx = a[1]*ssin(f[1]*x, p[1]) + a[2]*ccos(f[2]*y, p[2]) + a[4]*ssin(f[4]*z, p[1]) + a[5]*ccos(f[5]*t, p[2]);
+        yy = a[6]*ccos(f[6]*x, p[2]) + a[7]*ssin(f[7]*y, p[1]) + a[8]*ccos(f[8]*z, p[2]) + a[8]*ssin(f[8]*t, p[1]);
+        zz = a[9]*ssin(f[9]*x, p[1]) + a[10]*ssin(f[10]*y, p[2]) + a[11]*ccos(f[11]*z, p[1]) + a[12]*ccos(f[12]*t, p[2]);
+    }
+
+    void advance(double &xx, double &yy, double &zz) { //next in whichever the sketch is set to
+        if(!single) {
+            next(xx, yy, zz);
+            return;
+        }
+        float fx, fy, fz;
+        next(fx, fy, fz);
+        xx = fx, yy = fy, zz = fz;
+    }
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+        budget = 6000000; //attractor iterations
+        noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+
+        if(random(1) <= 0.4) mult = 1;//doing wrong 3d projection sometimes looks cool
+
+        for(int i = 1; i <= 12; i++) //important to keep these close to 1.0
+            a[i] = random(0.7, 1.2) * (random(0, 100) > 50 ? -1: 1),
+            f[i] = random(0.7, 1.2) * (random(0, 100) > 50 ? -1: 1);
+        v = random(0.0001, 0.01); //important to keep this low
+        p[1] = random(1, 5);
+        p[2] = random(1, 5);
+
+        if(random(1) <= 0.85) {
+            p[1] = random(-5.99, 0);
+            if(random(1) <= 0.7) p[2] = random(-4.99, 0);
+            v = random(0.00005, 0.0007);
+        }
+
+        buffer->begin();
+        buffer->background(ofColor(0));
+        buffer->setColor(ofColor(255));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        buffer->end();
+
+        {
+            trace_scope warmup(tracer, "warmup");
+            for(int i = 1; i <= 10000; i++) { //calculate some initial points to setup averages
+                double xx, yy, zz;
+                advance(xx, yy, zz);
+                t += v;
+                x = xx;
+                y = yy;
+                z = zz;
+
+                avgx += x;
+                avgy += y;
+                avgz += z;
+            }
+
+            avgx /= 10000;
+            avgy /= 10000;
+            avgz /= 10000;
+
+            x = y = z = t = 0;
+
+            cam = ofVec3f(avgx, avgy, avgz); //putting camera in the center yields better results
+
+            for(int i = 1; i <= 10000; i++) { //calculate points again to setup distance bounds
+                double xx, yy, zz;
+                advance(xx, yy, zz);
+                t += v;
+                x = xx;
+                y = yy;
+                z = zz;
+                double d = sqrt(pow(x-avgx, 2)+pow(y-avgy, 2)+pow(z-avgz, 2));
+
+                mind = min(mind, d);
+                maxd = max(maxd, d);
+            }
+        }
+
+        x = y = z = t = 0;
+
+        //setup color palette
+        double hue = random(1);
+        hues.push_back(hue);
+        hues.push_back(fmod(hue+random(0.4, 0.6), 1));
+
+        view = camera(cam, fov, width, height, mult);
+    }
+
+    void update() {
+        trace_total splat(tracer, "splat");
+        int n = min((long long)iterations, budget - spent);
+        //the frame's points, after the one it starts from, then where they all land at once
+        xs.resize(n+1), ys.resize(n+1), zs.resize(n+1);
+        screen_x.resize(n), screen_y.resize(n), depths.resize(n);
+        xs[0] = x, ys[0] = y, zs[0] = z;
+        for(int i = 1; i <= n; i++) {
+            double xx, yy, zz;
+            advance(xx, yy, zz);
+            t += v;
+            xs[i] = x = xx;
+            ys[i] = y = yy;
+            zs[i] = z = zz;
+        }
+        view.depthAndProject(n, xs.data()+1, ys.data()+1, zs.data()+1, screen_x.data(), screen_y.data(), depths.data());
+        //color depends on how far each point is from the previous one
+        point_hues.resize(n), sats.resize(n), colors.resize(n);
+        for(int i = 1; i <= n; i++) {
+            double step = ofMap(sqrt(pow(xs[i-1]-xs[i], 2)+pow(ys[i-1]-ys[i], 2)+pow(zs[i-1]-zs[i], 2)), 0, maxd*1.65, 0, 1);
+            point_hues[i-1] = ofLerp(hues[0], hues[1], step);
+            sats[i-1] = min(step+0.3, 0.8);
+        }
+        shades.lookup(n, point_hues.data(), sats.data(), colors.data());
+
+        buffer->begin();
+        for(int i = 1; i <= n; i++, spent++) {
+            double d = depths[i-1], xxx = screen_x[i-1], yyy = screen_y[i-1]; //distance from camera, 3d projection
+
+            splat.begin();
+            if(margins.inside(rnd, xxx, yyy)) { //borders
+                double dd = ofMap(d, mind, maxd, 1, 0.01);
+                buffer->enableBlendMode(OF_BLENDMODE_ADD);
+                ofFloatColor c = colors[i-1];
+                c.a = 0.15*dd;
+
+                buffer->setColor(c);
+                buffer->drawPoint(xxx, yyy);
+                stats.points++;
+            }
+            else stats.rejected++;
+            splat.end();
+        }
+        buffer->end();
+    }
+
+    bool done() {
+        return spent >= budget;
+    }
+
+    void persist(archive &a) { //the border gaussians come from rnd, which the sketch saves itself
+        a.io(x, y, z, t);
+    }
+
+    void describe(std::ostream &out) {
+        out << "noise_seed=" << noise_seed << "\n";
+        out << "mult=" << mult << "\n";
+        out << "a=" << join(vector<double>(a+1, a+13)) << "\n";
+        out << "f=" << join(vector<double>(f+1, f+13)) << "\n";
+        out << "v=" << v << "\n";
+        out << "p=" << p[1] << "," << p[2] << "\n";
+        out << "cam=" << cam.x << "," << cam.y << "," << cam.z << "\n";
+        out << "fov=" << fov << "\n";
+        out << "hues=" << join(hues) << "\n";
+    }
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+//random curves and glyphs on a triangle, square or hex grid
+
+#include "../../common/sketch.h"
+#include "../../common/noise.h"
+
+#define sq3 sqrt(3)/2
+
+//c++ has trash unicode support
+
+void GetUnicodeChar(unsigned int code, char chars[5]) {
+    if (code <= 0x7F) {
+        chars[0] = (code & 0x7F); chars[1] = '\0';
+    } else if (code <= 0x7FF) {
+        // one continuation byte
+        chars[1] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[0] = 0xC0 | (code & 0x1F); chars[2] = '\0';
+    } else if (code <= 0xFFFF) {
+        // two continuation bytes
+        chars[2] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[1] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[0] = 0xE0 | (code & 0xF); chars[3] = '\0';
+    } else if (code <= 0x10FFFF) {
+        // three continuation bytes
+        chars[3] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[2] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[1] = 0x80 | (code & 0x3F); code = (code >> 6);
+        chars[0] = 0xF0 | (code & 0x7); chars[4] = '\0';
+    } else {
+        // unicode replacement character
+        chars[2] = 0xEF; chars[1] = 0xBF; chars[0] = 0xBD;
+        chars[3] = '\0';
+    }
+}
+
+struct hexgrid_sketch : sketch {
+    hexgrid_sketch() : sketch("hexgrid", 2000, 2000, 3) {} //2: ziggurat gaussians, 3: philox streams
+
+    typeface *glyphs, *font;
+
+    double noise_seed, font_size = 30;
+
+    double safeguard = 0.03;
+
+    double line_chance;
+    double fill_chance;
+    double noise_mult;
+    double letter_chance;
+    double grid_size;
+    static constexpr double smallest_grid = 35, largest_grid = 130;
+    std::vector<int> hues;
+    std::vector<ofColor> colors;
+    std::string grid_type;
+    int N; //most curves in a cell
+    std::vector<ofVec2f> points; //every curve's control points, for the big curves at the end
+
+    bool finished = false; //everything is drawn in setup
+
+    double cell_noise[3]; //at the cell being drawn, for noise_seed, noise_seed+1000 and noise_seed+2000
+
+    void cellNoise(double x, double y) { //two octaves of all three in one batch, they only change between cells
+        float xs[6], ys[6], zs[6], n[6];
+        for(int i = 0; i < 3; i++) {
+            xs[i] = x / width, ys[i] = y / width, zs[i] = noise_seed + 1000 * i;
+            xs[i+3] = xs[i] * 2, ys[i+3] = ys[i] * 2, zs[i+3] = zs[i];
+        }
+        noise::noise(6, xs, ys, zs, n);
+        for(int i = 0; i < 3; i++) cell_noise[i] = min(1.0, n[i] + 0.5 * n[i+3]);
+    }
+
+    double getNoise(rng &r, int seed) { //seed is 0, 1 or 2 for the three above
+        return cell_noise[seed] + r.gaussian(0, 0.2);
+    }
+
+    ofColor &cellColor(rng &r) { //the noise can leave 0-1, that used to read past the palette
+        return colors[max(0, min(2, (int)(getNoise(r, 2)*3)))];
+    }
+
+    int rndChar(rng &r) { //random character from a few interesting blocks
+        vector<vector<int> > v = {
+            {0x2300, 0x23E8},
+            {0x25FF, 0x25A0},
+            {0x259F, 0x2500},
+            {0x2190, 0x21FF}
+        };
+        auto p = v[(int)r.random(v.size())];
+        return r.random(p[1]-p[0])+p[0];
+    }
+
+    void loadFonts() {
+        glyphs = &loadFont("segoe.ttf", font_size, {
+            ofUnicode::Arrows,
+            ofUnicode::MiscTechnical,
+            ofUnicode::BoxDrawing,
+            ofUnicode::BlockElement,
+            ofUnicode::GeometricShapes
+        });
+        font = &loadFont("sans.ttf", 30);
+    }
+
+    void loadAllFonts() { //in every size a grid can ask for, for the daemon to have ready
+        for(font_size = (int)(smallest_grid*0.8); font_size < largest_grid*0.8; font_size++) loadFonts();
+    }
+
+    void drawCell(rng &r, double x, double y) { //the curves and glyph anchored at one grid point
+        cellNoise(x, y);
+        int n = getNoise(r, 0)*N; //how many points
+        for(int i = 1; i <= n; i++) {
+            vector<ofVec2f> v;
+            for(int j = 1; j <= 4; j++) { //need 4 points for bezier
+                if(grid_type == "triangle") {
+                    double xx = ((int)y/(int)(grid_size*sq3) % 2 ? 0 : grid_size/2), yy = 0; //anchor point
+                    vector<ofVec2f> w = {ofVec2f(x, y), ofVec2f(x+grid_size, y), ofVec2f( x+grid_size/2, y-grid_size*sq3)}; //other possible points
+                    auto u = w[(int)r.random(3)]; //choose one randomly
+                    v.push_back(ofVec2f(xx+u.x, yy+u.y));
+                } else if(grid_type == "hex") {
+                    double xx = ((int)y/(int)(grid_size*1.5) % 2 ? 0 : grid_size*sq3), yy = 0;
+                    vector<ofVec2f> w = {
+                        ofVec2f(x, y), ofVec2f(x+grid_size*sq3, y-grid_size/2), ofVec2f( x+grid_size*sq3*2, y),
+                        ofVec2f(x, y+grid_size), ofVec2f(x+grid_size*sq3, y+grid_size*1.5), ofVec2f(x+grid_size*sq3*2, y+grid_size)
+                    };
+                    auto u = w[(int)r.random(6)];
+                    v.push_back(ofVec2f(xx+u.x, yy+u.y));
+                } else {
+                    double xx = 0, yy = 0;
+                    vector<ofVec2f> w = {ofVec2f(x, y), ofVec2f(x+grid_size, y), ofVec2f(x+grid_size, y+grid_size), ofVec2f(x, y+grid_size)};
+                    auto u = w[(int)r.random(4)];
+                    v.push_back(ofVec2f(xx+u.x, yy+u.y));
+                }
+            }
+
+            for(auto &i : v) points.push_back(i); //save points for later
+
+            buffer->setColor(cellColor(r));
+
+            if(i == 1 && getNoise(r, 2) <= letter_chance) {
+                char c[5];
+                GetUnicodeChar(rndChar(r), c);
+                auto rect = glyphs->getStringBoundingBox(c, 0, 0);
+                buffer->drawString(*glyphs, c, x+(grid_size-rect.width)/2, y-(grid_size-rect.height)/2);
+            }
+
+            if(getNoise(r, 0) <= fill_chance) buffer->fill();
+            else buffer->noFill();
+
+            if(getNoise(r, 1) <= line_chance) {
+                buffer->drawLine(v[0].x, v[0].y, v[1].x, v[1].y);
+                buffer->drawLine(v[2].x, v[2].y, v[3].x, v[3].y);
+            } else {
+                buffer->drawBezier(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+                buffer->noFill();
+                buffer->drawBezier(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+            }
+        }
+
+        if(grid_type == "triangle") { //triangular grid needs a second pass
+            int n = getNoise(r, 0)*N;
+            for(int i = 1; i <= n; i++) {
+                vector<ofVec2f> v;
+                for(int j = 1; j <= 4; j++) {
+                    double xx = ((int)y/(int)(grid_size*sq3) % 2 ? 0 : grid_size/2), yy = 0;
+                    vector<ofVec2f> w = {ofVec2f(x+grid_size, y), ofVec2f(x+grid_size/2, y-grid_size*sq3), ofVec2f( x+grid_size*1.5, y-grid_size*sq3)};
+                    auto u = w[(int)r.random(3)];
+                    v.push_back(ofVec2f(xx+u.x, yy+u.y));
+                }
+                for(auto &i : v) points.push_back(i);
+                if(getNoise(r, 0) <= fill_chance) buffer->fill();
+                else buffer->noFill();
+                buffer->setColor(cellColor(r));
+
+                if(getNoise(r, 1) <= line_chance) {
+                    buffer->drawLine(v[0].x, v[0].y, v[1].x, v[1].y);
+                    buffer->drawLine(v[2].x, v[2].y, v[3].x, v[3].y);
+                } else {
+                    buffer->drawBezier(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+                    buffer->noFill();
+                    buffer->drawBezier(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+                }
+            }
+        }
+    }
+
+    void setup() {
+        noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+
+        buffer->begin();
+        buffer->background(ofColor(255));
+        drawGrain(0, 0, width, height);
+
+        //set up color palette
+        hues = {(int)random(255), (int)random(255)};
+        hues.push_back((hues[0]+127+(int)random(10))%255);
+        for(int i = 0; i < 3; i++) {
+            int aa = hues[i];
+            int s = (random(1) <= 0.5 ? random(50, 80) : random(150, 190));
+            int b = (random(1) <= 0.5 ? random(60, 100) : random(170, 230));
+            ofColor c;
+            c.setHsb(aa, s, b);
+            colors.push_back(c);
+        }
+
+        vector<string> grids = {"triangle", "square", "hex"};
+        grid_type = grids[(int)random(3)];
+
+        safeguard = 0.03;
+
+        line_chance = random(safeguard, 1-safeguard);
+        fill_chance = random(safeguard, 1-safeguard);
+        noise_mult = random(safeguard, 4);
+        letter_chance = gaussian(0, 0.5);
+        grid_size = random(smallest_grid, largest_grid);
+
+        font_size = grid_size * 0.8;
+        loadFonts();
+        N = random(20)+1;
+
+        buffer->pushMatrix();
+        if(random(1.0) <= 0.5) { //rotate by 45 degrees
+            buffer->translate(width/2, -height/2);
+            buffer->scale(1.3, 1.3);
+            buffer->rotateDeg(45);
+        }
+
+        //the math for calculating grid points could be written in a better way
+
+        int cell = 0;
+        for(double x = 0; x <= width; x += (grid_type == "hex" ? grid_size*sq3*2 : grid_size))
+            for(double y = 0; y <= height; y += (grid_type == "triangle" ? grid_size*sq3 : grid_type == "square" ? grid_size : grid_size*1.5)) {
+                rng r = rnd.stream("cell", cell++);
+                drawCell(r, x, y);
+            }
+
+        //draw big beziers/lines
+        int n = random(N);
+        for(int i = 1; i <= n; i++) {
+            vector<ofVec2f> v;
+            for(int i = 1; i <= 4; i++)
+                v.push_back(points[(int)random(points.size())]);
+            buffer->noFill();
+            buffer->setColor(colors[(int)random(3)]);
+            if(random(1) <= line_chance) {
+                buffer->drawLine(v[0].x, v[0].y, v[1].x, v[1].y);
+                buffer->drawLine(v[2].x, v[2].y, v[3].x, v[3].y);
+            } else buffer->drawBezier(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+        }
+
+        buffer->popMatrix();
+
+        //draw borders
+        buffer->setColor(ofColor(255));
+        buffer->fill();
+        buffer->drawRectangle(0, 0, width, 100);
+        buffer->drawRectangle(0, 0, 100, height);
+        buffer->drawRectangle(width-100, 0, 100, height);
+        buffer->drawRectangle(0, height-100, width, 100);
+        buffer->setColor(ofColor(0));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        buffer->end();
+        finished = true;
+    }
+
+    void update() {}
+
+    bool done() {
+        return finished;
+    }
+
+    void describe(std::ostream &out) {
+        out << "noise_seed=" << noise_seed << "\n";
+        out << "grid_type=" << grid_type << "\n";
+        out << "grid_size=" << grid_size << "\n";
+        out << "line_chance=" << line_chance << "\n";
+        out << "fill_chance=" << fill_chance << "\n";
+        out << "noise_mult=" << noise_mult << "\n";
+        out << "letter_chance=" << letter_chance << "\n";
+        out << "hues=" << join(hues) << "\n";
+    }
+};
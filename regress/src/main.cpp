@@ -0,0 +1,233 @@
+#include "ofMain.h"
+#include "../../common/sketches.h"
+#include <sys/stat.h>
+
+//renders a fixed set of seeds of every sketch on the cpu canvas, at a fraction of their budget,
+//and compares them with reference images, so a change that alters what the sketches draw shows up
+//usage: regress [-s sketch] [-r dir] [-o dir] [-b divisor] [-d block] [-psnr db] [-ssim index] [-j threads] [hex seeds...]
+//           compares with the references in -r pixel for pixel and exits with 1 when any image falls below either threshold
+//       regress -update [-s sketch] [-r dir] [-b divisor] [hex seeds...]
+//           renders the references
+//       regress -float [-s sketch] [-o dir] [-b divisor] [-d block] [-psnr db] [-ssim index] [hex seeds...]
+//           renders every seed twice, in double and with the float math of ART_FLOAT, and compares the two
+//a failing image leaves a heatmap of where it differs in -o, <sketch>-<seed>.diff.png
+//the references are pngs, they're only comparable between builds that render the same sketches
+
+vector<int> seeds = {0x1a2b3c, 0x56798ae7, 0xc0ffee};
+int divisor = 8; //of each sketch's budget, those without one render whole
+int block = 0; //images are compared averaged over blocks this size, 0 for the mode's own, see below
+double min_psnr = -1, min_ssim = -1; //under 0 for the mode's own
+
+//the same build draws the same image, so references are compared pixel for pixel and anything more
+//than a few hundred samples a level off fails: a missing seed label comes out under 40db and 0.9992,
+//the border moved in a pixel at 67db or more for flow and fujii, which leave few points near it
+const int exact_block = 1;
+const double exact_psnr = 90, exact_ssim = 0.9999;
+
+//float takes fujii's attractor and field's flames somewhere else after a few thousand steps,
+//but they splat the same density of points over the same shapes, which comes out the same over 8x8 blocks:
+//float renders come out above 33db and 0.93, another seed of fujii at 27db and 0.78, the rest far below
+const int float_block = 8;
+const double float_psnr = 30, float_ssim = 0.9;
+
+struct comparison {
+    double psnr, ssim;
+    bool same_size;
+};
+
+ofPixels render(const string &name, int seed, bool single) {
+    auto s = makeSketch(name);
+    s->single = single;
+    s->start(seed, std::make_unique<cpu_canvas>());
+    if(s->budget) s->budget = max(1ll, s->budget / divisor);
+    s->render();
+    ofPixels pix;
+    s->buffer->readToPixels(pix);
+    return pix;
+}
+
+//over every 8 bit sample, infinite when they're identical
+double psnr(const ofPixels &a, const ofPixels &b) {
+    double sum = 0;
+    for(size_t i = 0; i < a.size(); i++) {
+        double d = (double)a.getData()[i] - b.getData()[i];
+        sum += d*d;
+    }
+    if(sum == 0) return INFINITY;
+    return 10 * log10(255.0 * 255.0 / (sum / a.size()));
+}
+
+vector<double> luma(const ofPixels &p) {
+    vector<double> l(p.getWidth() * p.getHeight());
+    const unsigned char *d = p.getData();
+    int c = p.getNumChannels();
+    for(size_t i = 0; i < l.size(); i++)
+        l[i] = 0.299 * d[i*c] + 0.587 * d[i*c+1] + 0.114 * d[i*c+2];
+    return l;
+}
+
+//mean structural similarity of the luma over 8x8 windows, 4 pixels apart
+double ssim(const ofPixels &a, const ofPixels &b) {
+    const int size = 8, stride = 4;
+    const double c1 = pow(0.01 * 255, 2), c2 = pow(0.03 * 255, 2);
+    auto la = luma(a), lb = luma(b);
+    int w = a.getWidth(), h = a.getHeight();
+    double sum = 0;
+    int windows = 0;
+    for(int y = 0; y + size <= h; y += stride)
+        for(int x = 0; x + size <= w; x += stride) {
+            double ma = 0, mb = 0, va = 0, vb = 0, cov = 0;
+            for(int j = y; j < y + size; j++)
+                for(int i = x; i < x + size; i++) {
+                    ma += la[(size_t)j*w+i];
+                    mb += lb[(size_t)j*w+i];
+                }
+            ma /= size * size;
+            mb /= size * size;
+            for(int j = y; j < y + size; j++)
+                for(int i = x; i < x + size; i++) {
+                    double da = la[(size_t)j*w+i] - ma, db = lb[(size_t)j*w+i] - mb;
+                    va += da*da;
+                    vb += db*db;
+                    cov += da*db;
+                }
+            va /= size * size - 1;
+            vb /= size * size - 1;
+            cov /= size * size - 1;
+            sum += (2*ma*mb + c1) * (2*cov + c2) / ((ma*ma + mb*mb + c1) * (va + vb + c2));
+            windows++;
+        }
+    return windows ? sum / windows : 1;
+}
+
+//rgb averaged over n by n blocks, the last ones cut short at the edges
+ofPixels shrink(const ofPixels &p, int n) {
+    int w = p.getWidth(), h = p.getHeight(), c = p.getNumChannels();
+    int sw = (w + n - 1) / n, sh = (h + n - 1) / n;
+    ofPixels out;
+    out.allocate(sw, sh, OF_PIXELS_RGB);
+    for(int y = 0; y < sh; y++)
+        for(int x = 0; x < sw; x++)
+            for(int k = 0; k < 3; k++) {
+                int sum = 0, count = 0;
+                for(int j = y*n; j < min(h, y*n + n); j++)
+                    for(int i = x*n; i < min(w, x*n + n); i++, count++)
+                        sum += p.getData()[((size_t)j*w + i)*c + k];
+                out.getData()[((size_t)y*sw + x)*3 + k] = (sum + count/2) / count;
+            }
+    return out;
+}
+
+comparison compare(const ofPixels &a, const ofPixels &b) {
+    if(a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight())
+        return {0, 0, false};
+    if(block == 1) return {psnr(a, b), ssim(a, b), true};
+    ofPixels sa = shrink(a, block), sb = shrink(b, block);
+    return {psnr(sa, sb), ssim(sa, sb), true};
+}
+
+//the reference dimmed to grey, with every pixel that differs over it from red through yellow to white,
+//white at 64 levels or more in any channel
+ofPixels heatmap(const ofPixels &a, const ofPixels &b) {
+    ofPixels out;
+    out.allocate(a.getWidth(), a.getHeight(), OF_PIXELS_RGB);
+    int c = a.getNumChannels();
+    const unsigned char *pa = a.getData(), *pb = b.getData();
+    unsigned char *o = out.getData();
+    for(size_t i = 0; i < a.getWidth() * a.getHeight(); i++) {
+        int d = 0;
+        for(int k = 0; k < 3; k++) d = max(d, abs(pa[i*c+k] - pb[i*c+k]));
+        if(!d) {
+            unsigned char grey = (0.299 * pa[i*c] + 0.587 * pa[i*c+1] + 0.114 * pa[i*c+2]) / 4;
+            o[i*3] = o[i*3+1] = o[i*3+2] = grey;
+            continue;
+        }
+        double t = min(1.0, d / 64.0);
+        o[i*3] = 255 * min(1.0, 3*t);
+        o[i*3+1] = 255 * ofClamp(3*t - 1, 0, 1);
+        o[i*3+2] = 255 * ofClamp(3*t - 2, 0, 1);
+    }
+    return out;
+}
+
+int main(int argc, char *argv[]){
+    string references = "../references/", diffs = "../diffs/", only;
+    bool update = false, single = false;
+    int threads = 0;
+    vector<int> chosen;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-s" && i+1 < argc) only = argv[++i];
+        else if(arg == "-r" && i+1 < argc) references = string(argv[++i]) + "/";
+        else if(arg == "-o" && i+1 < argc) diffs = string(argv[++i]) + "/";
+        else if(arg == "-b" && i+1 < argc) divisor = max(1, stoi(argv[++i]));
+        else if(arg == "-d" && i+1 < argc) block = max(1, stoi(argv[++i]));
+        else if(arg == "-psnr" && i+1 < argc) min_psnr = stod(argv[++i]);
+        else if(arg == "-ssim" && i+1 < argc) min_ssim = stod(argv[++i]);
+        else if(arg == "-j" && i+1 < argc) threads = stoi(argv[++i]);
+        else if(arg == "-update") update = true;
+        else if(arg == "-float") single = true;
+        else chosen.push_back(stoul(arg, nullptr, 16));
+    }
+    if(!chosen.empty()) seeds = chosen;
+    if(update) single = false; //references are always the double renders
+    if(block <= 0) block = (single ? float_block : exact_block);
+    if(min_psnr < 0) min_psnr = (single ? float_psnr : exact_psnr);
+    if(min_ssim < 0) min_ssim = (single ? float_ssim : exact_ssim);
+    if(!only.empty() && !makeSketch(only)) {
+        cerr << "no sketch called " << only << endl;
+        return 2;
+    }
+
+    struct job {
+        string sketch;
+        int seed;
+        bool failed = false;
+    };
+    vector<job> jobs;
+    for(auto &name : sketchNames())
+        if(only.empty() || name == only)
+            for(int seed : seeds) jobs.push_back({name, seed});
+
+    mkdir(update ? references.c_str() : diffs.c_str(), 0777);
+    std::mutex printing;
+    thread_pool pool(threads);
+    for(auto &j : jobs)
+        pool.submit([&] {
+            string id = j.sketch + "-" + ofToHex(j.seed), reference = references + id + ".png";
+            char line[256];
+            ofPixels pix = render(j.sketch, j.seed, single);
+            if(update) {
+                j.failed = !savePng(pix, reference, encoderThreads());
+                snprintf(line, sizeof(line), "%-24s %s", id.c_str(), j.failed ? "can't write" : "written");
+            }
+            else {
+                ofPixels expected;
+                if(single) expected = render(j.sketch, j.seed, false);
+                if(!single && !ofLoadImage(expected, reference)) {
+                    j.failed = true;
+                    snprintf(line, sizeof(line), "%-24s no reference, run regress -update", id.c_str());
+                }
+                else {
+                    auto c = compare(expected, pix);
+                    j.failed = !c.same_size || c.psnr < min_psnr || c.ssim < min_ssim;
+                    if(!c.same_size) snprintf(line, sizeof(line), "%-24s FAIL, %dx%d but the reference is %dx%d", id.c_str(),
+                        (int)pix.getWidth(), (int)pix.getHeight(), (int)expected.getWidth(), (int)expected.getHeight());
+                    else snprintf(line, sizeof(line), "%-24s psnr=%7.2f ssim=%.4f %s", id.c_str(), c.psnr, c.ssim,
+                        j.failed ? "FAIL" : (std::isinf(c.psnr) ? "identical" : "ok"));
+                    if(j.failed && c.same_size) savePng(heatmap(expected, pix), diffs + id + ".diff.png", encoderThreads());
+                }
+            }
+            std::lock_guard<std::mutex> lock(printing);
+            printf("%s\n", line);
+            fflush(stdout);
+        });
+    pool.wait();
+
+    int failed = 0;
+    for(auto &j : jobs) failed += j.failed;
+    if(update) printf("%d references in %s\n", (int)jobs.size() - failed, references.c_str());
+    else printf("%d of %d %s (psnr under %g or ssim under %g)\n", failed, (int)jobs.size(),
+        single ? "float renders differ from double" : "renders differ from the references", min_psnr, min_ssim);
+    return failed ? 1 : 0;
+}
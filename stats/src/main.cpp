@@ -0,0 +1,152 @@
+#include "ofMain.h"
+#include <dirent.h>
+
+//reads the .stats sidecars renders leave next to their images
+//usage: stats dir                          medians and spread of every field, per sketch
+//       stats before after [-x percent]    compares two runs, say the same seeds on two builds,
+//                                          and exits with 1 when anything got more than x% slower
+//seeds rendered in both runs are compared one to one, otherwise it's median against median
+
+typedef map<string, string> record;
+
+double threshold = 10; //percent, renders sharing a machine easily drift by 5
+double min_time = 1; //milliseconds, phases shorter than this are too noisy to call regressions
+
+vector<record> load(const string &dir) {
+    vector<record> records;
+    DIR *d = opendir(dir.c_str());
+    if(!d) {
+        cerr << "can't open " << dir << endl;
+        return records;
+    }
+    while(auto entry = readdir(d)) {
+        string file = entry->d_name;
+        if(file.size() < 6 || file.substr(file.size()-6) != ".stats") continue;
+        ifstream in(dir + "/" + file);
+        record r;
+        string line;
+        while(getline(in, line)) {
+            auto eq = line.find('=');
+            if(eq != string::npos) r[line.substr(0, eq)] = line.substr(eq+1);
+        }
+        if(r.count("sketch")) records.push_back(r);
+    }
+    closedir(d);
+    return records;
+}
+
+bool numeric(const string &key) { //the fields that describe the render rather than name it
+    return key != "sketch" && key != "version" && key != "seed" && key != "width" && key != "height" && key != "budget" && key != "formats" && key != "sizes";
+}
+
+//1 when bigger is worse, -1 when smaller is worse, 0 when it's work done rather than speed
+int direction(const string &key) {
+    if(key.find("_per_second") != string::npos) return -1;
+    if(key.rfind("wall.", 0) == 0 || key.rfind("cpu.", 0) == 0 || key == "peak_rss_kb") return 1;
+    return 0;
+}
+
+bool timing(const string &key) {
+    return key.rfind("wall.", 0) == 0 || key.rfind("cpu.", 0) == 0;
+}
+
+double percentile(vector<double> v, double p) {
+    if(v.empty()) return 0;
+    sort(v.begin(), v.end());
+    return v[min(v.size()-1, (size_t)(p * v.size()))];
+}
+
+//every value of every numeric field, by sketch then field
+map<string, map<string, vector<double> > > collect(const vector<record> &records) {
+    map<string, map<string, vector<double> > > fields;
+    for(auto &r : records)
+        for(auto &f : r)
+            if(numeric(f.first)) fields[r.at("sketch")][f.first].push_back(atof(f.second.c_str()));
+    return fields;
+}
+
+void summary(const vector<record> &records) {
+    for(auto &s : collect(records)) {
+        printf("%s\n", s.first.c_str());
+        printf("  %-28s %6s %14s %14s %14s %14s\n", "", "n", "median", "mean", "p10", "p90");
+        for(auto &f : s.second) {
+            double mean = 0;
+            for(double v : f.second) mean += v / f.second.size();
+            printf("  %-28s %6d %14.6g %14.6g %14.6g %14.6g\n", f.first.c_str(), (int)f.second.size(),
+                percentile(f.second, 0.5), mean, percentile(f.second, 0.1), percentile(f.second, 0.9));
+        }
+    }
+}
+
+string identity(const record &r) { //renders that should have done exactly the same work
+    return r.at("sketch") + " " + (r.count("seed") ? r.at("seed") : "") + " " +
+        (r.count("version") ? r.at("version") : "") + " " + (r.count("budget") ? r.at("budget") : "");
+}
+
+int compare(const vector<record> &before, const vector<record> &after) {
+    auto a = collect(before), b = collect(after);
+    map<string, const record *> paired;
+    for(auto &r : before) paired[identity(r)] = &r;
+
+    int regressions = 0;
+    for(auto &s : b) {
+        if(!a.count(s.first)) continue;
+        vector<pair<const record *, const record *> > pairs;
+        for(auto &r : after)
+            if(r.at("sketch") == s.first && paired.count(identity(r))) pairs.push_back({paired[identity(r)], &r});
+
+        printf("%s (%d before, %d after, %d seeds in both)\n", s.first.c_str(),
+            (int)a[s.first].begin()->second.size(), (int)s.second.begin()->second.size(), (int)pairs.size());
+        printf("  %-28s %14s %14s %9s\n", "", "before", "after", "change");
+        for(auto &f : s.second) {
+            auto &old = a[s.first][f.first];
+            if(old.empty()) continue;
+            double from = percentile(old, 0.5), to = percentile(f.second, 0.5);
+
+            //the median of the per-seed ratios when there are seeds in both, it cancels out
+            //how much work each seed happens to need
+            double change = (from != 0 ? to / from - 1 : 0);
+            int differing = 0;
+            if(!pairs.empty()) {
+                vector<double> ratios;
+                for(auto &p : pairs) {
+                    if(!p.first->count(f.first) || !p.second->count(f.first)) continue;
+                    double x = atof(p.first->at(f.first).c_str()), y = atof(p.second->at(f.first).c_str());
+                    if(x != y) differing++;
+                    if(x != 0) ratios.push_back(y / x);
+                }
+                if(!ratios.empty()) change = percentile(ratios, 0.5) - 1;
+            }
+
+            string note;
+            int dir = direction(f.first);
+            if(dir && change * dir * 100 > threshold && !(timing(f.first) && max(from, to) < min_time)) {
+                note = "REGRESSION";
+                regressions++;
+            }
+            else if(!dir && differing) note = "differs for " + ofToString(differing) + " seeds"; //the renders changed, not just their speed
+            printf("  %-28s %14.6g %14.6g %+8.1f%% %s\n", f.first.c_str(), from, to, change * 100, note.c_str());
+        }
+    }
+    printf("%d regressions over %g%%\n", regressions, threshold);
+    return regressions ? 1 : 0;
+}
+
+int main(int argc, char *argv[]){
+    vector<string> dirs;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-x" && i+1 < argc) threshold = stod(argv[++i]);
+        else dirs.push_back(arg);
+    }
+
+    if(dirs.size() == 1) {
+        summary(load(dirs[0]));
+        return 0;
+    }
+    if(dirs.size() == 2) return compare(load(dirs[0]), load(dirs[1]));
+
+    cerr << "usage: stats dir" << endl;
+    cerr << "       stats before after [-x percent]" << endl;
+    return 2;
+}
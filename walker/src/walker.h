@@ -0,0 +1,203 @@
+#pragma once
+
+//this was inspired by a gif i saw on twitter once
+//i never found it again though and can't remember the author
+
+#include "../../common/sketch.h"
+#include "../../common/noise.h"
+
+struct walker_sketch;
+
+struct walker {
+    double x, y, angle, speed_mult = 1;
+    int shade = 0, circular = 0, parent, id;
+    std::set<int> children;
+    rng r; //its own stream, children get theirs from their id
+    walker() {} //to be read from a checkpoint
+    walker(walker_sketch &s, double x, double y, double angle, int parent, int id);
+    void persist(archive &a) { a.io(x, y, angle, speed_mult, shade, circular, parent, id, children, r); }
+    bool update(walker_sketch &s);
+    bool update(walker_sketch &s, double noise); //noise at x, y when it's been done for every walker at once
+    void draw(walker_sketch &s);
+};
+
+struct walker_sketch : sketch {
+    walker_sketch() : sketch("walker", 2000, 2000, 4) {} //2: ziggurat gaussians, 3: philox streams, 4: border stencil
+
+    int frame_limit = 720; //frames, used to be 12 seconds
+    int frame = 0;
+
+    typeface *font;
+
+    std::vector<int> angles;
+    std::vector<std::vector<int> > vis;
+    std::vector<walker> walkers;
+    std::vector<float> noise_x, noise_y, noise_z, noises; //for every walker at the start of a frame
+
+    double speed = 0.15;
+    double spawn_chance = 0.003;
+    double acceleration = 0.1; //circle radius
+    double circle_chance = 0.5;
+    double distortion = 1;
+    double distort_level = 0;
+    double warp = 0;
+    int parameter_changes = 0;
+    int change_frame = 0;
+    double direction = 1;
+    double noise_seed;
+
+    int counter = 1;
+
+    int angle(rng &r) {
+        return angles[(int)r.random(angles.size())];
+    }
+
+    void randomiseParameters() {
+        acceleration = random(0.005, 0.4);
+        circle_chance = random(-0.2, 0.4);
+        if(random(1.0) <= 0.3) circle_chance = random(0.8, 1);
+        distortion = random(1.0);
+        distort_level = max(0.0, min(1.0, gaussian(0, 0.25)));
+        warp = max(0.0, min(1.0, gaussian((random(1.0) <= 0.3 ? 1 : 0), 1)));
+        speed = random(0.1, 0.35);
+        spawn_chance = random(0.001, 0.015);
+        direction = (random(1.0) <= 0.5 ? 1 : -1);
+    }
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+        noise_seed = random(1000);
+
+        buffer->allocate(width, height);
+        vis.assign(width, std::vector<int>(height, 0));
+
+        std::vector<int> possible_angles = {20, 45, 60, 90, 120, 160};
+        for(int i = 1; i <= (random(1) <= 0.2 ? 2 : 1); i++)
+            angles.push_back(possible_angles[(int)random(possible_angles.size())]);
+
+        if(random(1.0) <= 0.35) {
+            parameter_changes = (int)random(3)+1;
+            change_frame = frame_limit/(parameter_changes+1);
+        }
+
+        randomiseParameters();
+
+        int starting = (int)random(40)+1; //inital walkers
+        for(int i = 1; i <= starting; i++)
+            walkers.push_back(walker(*this, random(width), random(height), (int)random(10)*angle(rnd), 0, ++counter));
+        stats.counts["walkers_started"] = starting;
+
+        buffer->begin();
+        buffer->background(ofColor(255));
+        buffer->setColor(ofColor(0));
+        drawStringCentered(*font, seedstring, width/2, height-50);
+        drawGrain(100, 100, width-199, height-199);
+        buffer->end();
+    }
+
+    bool blocked(const walker &w) { //check if a line has been hit
+        if(w.x < 0 || w.x >= width || w.y < 0 || w.y >= height) return true;
+        int v = vis[(int)w.x][(int)w.y];
+        return v != 0 && //pixel is occupied
+               v != w.id && //does not belong to us
+               v != w.parent && //our parent
+               !w.children.count(v); //or our child
+    }
+
+    void update() {
+        frame++;
+        if(parameter_changes &&
+           frame >= change_frame) {
+            change_frame += frame_limit/(parameter_changes+1);
+            randomiseParameters();
+        }
+
+        {
+            //a walker hasn't moved when it's reached, only the ones after it get erased and
+            //children go on the end, so walkers[i] is still the one the noise was done for
+            trace_scope batch(tracer, "noise");
+            int n = walkers.size();
+            noise_x.resize(n), noise_y.resize(n), noise_z.assign(n, noise_seed), noises.resize(n);
+            for(int i = 0; i < n; i++) noise_x[i] = walkers[i].x/width, noise_y[i] = walkers[i].y/height;
+            noise::noise(n, noise_x.data(), noise_y.data(), noise_z.data(), noises.data());
+        }
+
+        for(int i = walkers.size()-1; i >= 0; i--) { //loop backwards to avoid skipping
+            if(walkers[i].update(*this, noises[i])) { //if child is spawned
+                auto &r = walkers[i].r;
+                walkers.push_back(walker(*this, walkers[i].x, walkers[i].y, walkers[i].angle + (r.random(1.0) < 0.5 ? 1 : -1)*angle(r), walkers[i].id, ++counter));
+                walkers[i].children.insert(counter);
+                stats.counts["walkers_spawned"]++;
+            }
+
+            if(blocked(walkers[i])) {
+                walkers.erase(walkers.begin()+i); //then die
+                stats.counts["walkers_killed"]++;
+            }
+            else vis[(int)walkers[i].x][(int)walkers[i].y] = walkers[i].id; //else mark it as occupied
+        }
+
+        trace_scope splat(tracer, "splat");
+        buffer->begin(); //once for every walker, the fbo batches their rectangles into a draw call
+        for(auto &w : walkers)
+            w.draw(*this);
+        buffer->end();
+    }
+
+    bool done() { //every walker has died or we ran out of frames
+        return walkers.empty() || frame >= frame_limit;
+    }
+
+    void persist(archive &a) { //parameter changes included, they're drawn from rnd as the frames go by
+        a.io(frame, change_frame, acceleration, circle_chance, distortion, distort_level, warp, speed, spawn_chance, direction);
+        a.io(counter, walkers, vis);
+    }
+
+    void describe(std::ostream &out) { //the first set of parameters, later changes follow from the seed
+        out << "noise_seed=" << noise_seed << "\n";
+        out << "angles=" << join(angles) << "\n";
+        out << "parameter_changes=" << parameter_changes << "\n";
+        out << "acceleration=" << acceleration << "\n";
+        out << "circle_chance=" << circle_chance << "\n";
+        out << "distortion=" << distortion << "\n";
+        out << "distort_level=" << distort_level << "\n";
+        out << "warp=" << warp << "\n";
+        out << "speed=" << speed << "\n";
+        out << "spawn_chance=" << spawn_chance << "\n";
+        out << "direction=" << direction << "\n";
+    }
+};
+
+walker::walker(walker_sketch &s, double x, double y, double angle, int parent, int id) : x(x), y(y), angle(angle), parent(parent), id(id) {
+    r = s.rnd.stream("walker", id);
+    if(r.random(1.0) <= s.circle_chance) circular = (r.random(1.0) >= 0.5 ? -1 : 1);
+    speed_mult = r.random(0.2, 2);
+    if(r.random(1.0) <= 0.025) speed_mult = 8;
+    shade = r.random(80);
+}
+
+bool walker::update(walker_sketch &s) {
+    return update(s, noise::noise(x/s.width, y/s.height, s.noise_seed));
+}
+
+bool walker::update(walker_sketch &s, double noise) {
+    if(!circular && r.random(1.0) <= 0.0005) circular = (r.random(1.0) >= 0.5 ? -1 : 1);
+    if(r.random(1.0) <= 0.002) circular *= -1; //chance to change direction
+    if(circular) angle += circular*s.acceleration;
+    noise *= s.distortion;
+    double distort = ofMap(noise, 0, 1, 1, r.random(1.3));
+    double aa = (angle*PI/180 + distort*s.warp)*(1-distort*s.distort_level);
+    x += cos(aa) * s.speed * speed_mult * s.direction;
+    y += sin(aa) * s.speed * speed_mult * s.direction;
+    if(r.random(1.0) <= s.spawn_chance) return 1; //spawn child
+    return 0;
+}
+
+void walker::draw(walker_sketch &s) { //between the sketch's begin and end
+    s.buffer->setColor(ofColor(shade));
+    if(s.margins.inside(r, x, y)) { //borders
+        s.buffer->drawRectangle(x+r.gaussian(0, 1)*0.05, y+r.gaussian(0, 1)*0.05, 1+r.gaussian(0, 0.5), 1+r.gaussian(0, 0.5));
+        s.stats.points++;
+    }
+    else s.stats.rejected++;
+}
@@ -5,8 +5,6 @@
 class ofApp : public ofBaseApp{
 
 	public:
-        ofFbo buffer;
-    
 		void setup();
 		void update();
 		void draw();
@@ -0,0 +1,182 @@
+#pragma once
+
+//refer to tyler hobbs' tutorial on drawing generative watercolor
+//https://tylerxhobbs.com/essays/2017/a-generative-approach-to-simulating-watercolor-paints
+//inspired by Kjetil Golid's work
+
+#include "../../common/sketch.h"
+
+struct watercolor_sketch;
+
+struct polygon {
+    std::vector<std::pair<double, double> > vertices;
+    std::vector<double> variation;
+    polygon(watercolor_sketch &s, rng &r, double y);
+    void deform(watercolor_sketch &s, rng &r, int count);
+    template<typename T> void deform(watercolor_sketch &s, rng &r, int count); //new points worked out in T
+};
+
+struct watercolor_sketch : sketch {
+    watercolor_sketch() : sketch("watercolor", 2000, 2000, 3) {} //2: ziggurat gaussians, 3: philox streams
+
+    int vertex_count = 6;
+    int layers = 8;
+    int frames_per_layer = 50;
+
+    bool finished = false;
+
+    typeface *font;
+
+    std::vector<int> hues;
+    std::vector<ofFloatColor> colors;
+    std::vector<int> framecount;
+    std::vector<polygon> polygons;
+    std::vector<rng> streams; //one for each layer
+
+    double initial_ydeviation = 40;
+    double variation_deviation = 0.3;
+    double depression_chance = 0.05; //areas with low variance
+    double variance_mult = 0.6; //very important
+    double yshift = 400;
+
+    void setup() {
+        font = &loadFont("sans.ttf", 30);
+
+        //randomize variables
+        layers = random(7, 10);
+        budget = layers * frames_per_layer; //deformation frames
+        yshift = random(300, 500);
+        initial_ydeviation = random(30, 100);
+        variation_deviation = random(0.1, 0.4);
+        depression_chance = random(0.02, 0.08);
+        variance_mult = random(0.55, 0.65);
+
+        buffer->allocate(width, height);
+
+        //set up color palette
+        hues = {(int)random(255), (int)random(255)};
+        hues.push_back((hues[0]+127+(int)random(10))%255);
+        //set up initial polygons
+        for(int i = 1; i <= layers; i++) {
+            streams.push_back(rnd.stream("layer", i));
+            polygon p(*this, streams.back(), height/(layers+1)*i);
+            p.deform(*this, streams.back(), 5);
+            polygons.push_back(p);
+            ofColor c;
+            int aa = hues[(int)random(3)];
+            aa = (aa + (int)random(20))%255;
+            //color depends on height
+            c.setHsb(aa, random(230, 250), (random(1.0) > ofMap(i, 1, layers, 0.9, 0.08) ? random(25) : random(100, 200)), 5);
+            ofFloatColor c2 = c;
+            c2.a = 0.02;
+            colors.push_back(c2);
+            framecount.push_back(0);
+        }
+
+        buffer->begin();
+        buffer->background(ofColor(255));
+        buffer->end();
+    }
+
+    void update() {
+        trace_total splat(tracer, "splat");
+        int i = 0;
+        for(auto p : polygons) {
+            if(framecount[i] < frames_per_layer) {
+                framecount[i]++;
+                spent++;
+
+                p.deform(*this, streams[i], 4);
+                p.vertices.insert(p.vertices.begin(), {0, p.vertices[0].second});
+
+                splat.begin();
+                buffer->begin();
+                buffer->setColor(colors[i]);
+                std::vector<ofVec2f> shape;
+                for(auto v : p.vertices)
+                    shape.push_back(ofVec2f(v.first, v.second));
+                buffer->drawShape(shape);
+
+                //draw borders
+                buffer->setColor(ofColor(255));
+                buffer->drawRectangle(0, 0, width, 100);
+                buffer->drawRectangle(0, 0, 100, height);
+                buffer->drawRectangle(width-100, 0, 100, height);
+                buffer->drawRectangle(0, height-100, width, 100);
+
+                //draw seed
+                buffer->setColor(ofColor(0));
+                drawStringCentered(*font, seedstring, width/2, height-50);
+                buffer->end();
+                splat.end();
+            }
+            i++;
+        }
+
+        if(spent >= min(budget, (long long)layers*frames_per_layer)) { //every layer has used up its frames
+            buffer->begin();
+            buffer->enableBlendMode(OF_BLENDMODE_MULTIPLY); //bring up the saturation
+            buffer->setColor(ofColor(255));
+            buffer->drawSelf();
+            buffer->end();
+            finished = true;
+        }
+    }
+
+    bool done() {
+        return finished;
+    }
+
+    void persist(archive &a) { //polygons are deformed on copies, they stay as setup left them
+        a.io(framecount, streams, finished);
+    }
+
+    void describe(std::ostream &out) {
+        out << "layers=" << layers << "\n";
+        out << "yshift=" << yshift << "\n";
+        out << "initial_ydeviation=" << initial_ydeviation << "\n";
+        out << "variation_deviation=" << variation_deviation << "\n";
+        out << "depression_chance=" << depression_chance << "\n";
+        out << "variance_mult=" << variance_mult << "\n";
+        out << "hues=" << join(hues) << "\n";
+    }
+};
+
+polygon::polygon(watercolor_sketch &s, rng &r, double y) {
+    for(int i = 0; i <= s.vertex_count; i++) {
+        vertices.emplace_back(s.width/s.vertex_count*i+r.gaussian(0, 1)*20, y+r.gaussian(0, 1)*s.initial_ydeviation);
+        double var = std::min(std::max(0.0, (r.random(1.0) > s.depression_chance ? r.gaussian(1, s.variation_deviation) : 0)), 1.0);
+        variation.push_back(var);
+    }
+
+    y += s.yshift * r.random(0.9, 1.1);
+    for(int i = s.vertex_count; i >= 0; i--) {
+        vertices.emplace_back(s.width/s.vertex_count*i+r.gaussian(0, 1)*20, y+r.gaussian(0, 1)*s.initial_ydeviation);
+        double var = std::min(std::max(0.0, r.gaussian(1, 0.1)), 1.0);
+        variation.push_back(var);
+    }
+}
+
+void polygon::deform(watercolor_sketch &s, rng &r, int count) {
+    if(s.single) deform<float>(s, r, count);
+    else deform<double>(s, r, count);
+}
+
+template<typename T>
+void polygon::deform(watercolor_sketch &s, rng &r, int count) {
+    for(int I = 1; I <= count; I++) {
+        for(int i = 0; i < vertices.size()-1; i+=2) {
+            int j = i+1;
+            T vx = vertices[i].first, vy = vertices[i].second, wx = vertices[j].first, wy = vertices[j].second;
+            T xx = vx/2+wx/2; //middle of line
+            T yy = vy/2+wy/2;
+            T new_var = (T(variation[i])/2+T(variation[j])/2)*T(0.9);
+            T variance = T(s.variance_mult) * new_var * sqrt((vx-wx)*(vx-wx) + (vy-wy)*(vy-wy)); //variance depends on length of line
+            std::pair<double, double> new_v = {
+                xx + T(r.gaussian(0, 1))*variance, yy + T(r.gaussian(0, 1))*variance
+            };
+            vertices.insert(vertices.begin()+i+1, new_v);
+            variation.insert(variation.begin()+i+1, new_var);
+        }
+    }
+}